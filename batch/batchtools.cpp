@@ -0,0 +1,512 @@
+#include "batchtools.h"
+#include <QCommandLineParser>
+#include <QFile>
+#include <QGuiApplication>
+#include <QTextStream>
+#include <QDebug>
+#include <functional>
+#include <map>
+
+#include "../canvas/freespaceexporter.h"
+#include "../geometry/closedfrechet.h"
+#include "../geometry/curveoracle.h"
+#include "../geometry/freespace.h"
+#include "../geometry/kcenter.h"
+#include "../geometry/lsh.h"
+#include "../geometry/mapmatching.h"
+#include "../geometry/planner.h"
+#include "../geometry/polylineio.h"
+#include "../geometry/resultcache.h"
+#include "../geometry/similarityjoin.h"
+#include "../geometry/simplification.h"
+#include "../geometry/translation.h"
+#include "../geometry/weakfrechet.h"
+
+namespace Batch {
+
+using Command = std::function<int(const QStringList& arguments)>;
+
+static int runExport(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render the free space diagram of a polyline file offscreen.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Polyline file (P / Q format).");
+    parser.addPositionalArgument("directory", "Output directory for the PNG tiles.");
+    QCommandLineOption epsOption("eps", "Distance threshold.", "value");
+    QCommandLineOption cellOption("cell-size", "Cell size in pixels.", "pixels", "50");
+    QCommandLineOption tileOption("tile-size", "Tile size in pixels.", "pixels", "2048");
+    QCommandLineOption pdfOption("pdf", "Also write a vector PDF.", "file");
+    parser.addOptions({epsOption, cellOption, tileOption, pdfOption});
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2 || !parser.isSet(epsOption))
+        parser.showHelp(1);
+
+    Polyline P, Q;
+    if (!readPolylines(args[0], P, Q))
+        return 1;
+
+    double eps = parser.value(epsOption).toDouble();
+    FreeSpace fs(P, Q, eps);
+    fs.computeReachability();
+
+    if (fs.isTopRightReachable()) {
+        auto& cache = Frechet::ResultCache::instance();
+        auto key = Frechet::ResultCache::key(P, Q);
+        if (!cache.findCriticalPath(key, fs.criticalPath)) {
+            fs.computeCriticalPath(fs.criticalPath);
+            cache.storeCriticalPath(key, fs.criticalPath);
+        }
+        fs.pathComputed = true;
+        fs.criticalEps = static_cast<int>(eps);
+    }
+
+    FreeSpaceExporter::Options options;
+    options.cellSize = std::max(1, parser.value(cellOption).toInt());
+    options.tileSize = std::max(64, parser.value(tileOption).toInt());
+    FreeSpaceExporter exporter(fs, options);
+
+    int tiles = exporter.exportTiles(args[1]);
+    if (tiles < 0) {
+        qWarning() << "Cannot write tiles to" << args[1];
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out << "Wrote " << tiles << " tiles (" << exporter.imageSize().width() << "x"
+        << exporter.imageSize().height() << ") to " << args[1] << Qt::endl;
+
+    if (parser.isSet(pdfOption)) {
+        if (!exporter.exportPdf(parser.value(pdfOption))) {
+            qWarning() << "Cannot write" << parser.value(pdfOption);
+            return 1;
+        }
+        out << "Wrote " << parser.value(pdfOption) << Qt::endl;
+    }
+
+    return 0;
+}
+
+static int runDistance(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Frechet and weak Frechet distance of a polyline pair.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Polyline file (P / Q format).");
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1)
+        parser.showHelp(1);
+
+    Polyline P, Q;
+    if (!readPolylines(args[0], P, Q))
+        return 1;
+
+    QTextStream out(stdout);
+    out << "frechet " << Frechet::Planner(P, Q).distance() << Qt::endl;
+    out << "weak " << Frechet::weakFrechetDistance(P, Q) << Qt::endl;
+
+    return 0;
+}
+
+static int runDecide(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Decide d_F(P,Q) <= eps with the cheapest engine that fits in memory.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Polyline file (P / Q format).");
+    QCommandLineOption epsOption("eps", "Distance threshold.", "value");
+    QCommandLineOption memoryOption("memory", "Memory budget in MiB (default: half of the free memory).", "MiB");
+    QCommandLineOption tileOption("tile-cells", "Tile size in cells, out of core.", "cells",
+                                  QString::number(Frechet::TiledFreeSpace::DefaultTileSize));
+    QCommandLineOption scratchOption("scratch", "Directory for the scratch file, out of core.", "directory");
+    QCommandLineOption pathOption("path", "Also print a matching.");
+    parser.addOptions({epsOption, memoryOption, tileOption, scratchOption, pathOption});
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1 || !parser.isSet(epsOption))
+        parser.showHelp(1);
+
+    Polyline P, Q;
+    if (!readPolylines(args[0], P, Q))
+        return 1;
+
+    Frechet::Planner::Options options;
+    if (parser.isSet(memoryOption))
+        options.memoryBudget = static_cast<qint64>(parser.value(memoryOption).toDouble() * (1 << 20));
+    options.tileSize = parser.value(tileOption).toInt();
+    options.scratchDirectory = parser.value(scratchOption);
+    Frechet::Planner planner(P, Q, options);
+
+    double eps = parser.value(epsOption).toDouble();
+    QTextStream out(stdout);
+    if (parser.isSet(pathOption)) {
+        std::vector<QPointF> path = planner.matching(eps);
+        out << "within " << (path.empty() ? "no" : "yes") << Qt::endl;
+        for (const auto& p : path)
+            out << p.x() << " " << p.y() << Qt::endl;
+    } else {
+        out << "within " << (planner.decide(eps) ? "yes" : "no") << Qt::endl;
+    }
+
+    return 0;
+}
+
+static int runClosed(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Frechet distance between closed curves, over all cyclic shifts of P.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Polyline file (P / Q format).");
+    QCommandLineOption toleranceOption("tolerance", "Relative bisection tolerance.", "value", "1e-6");
+    parser.addOption(toleranceOption);
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1)
+        parser.showHelp(1);
+
+    Polyline P, Q;
+    if (!readPolylines(args[0], P, Q))
+        return 1;
+
+    Frechet::ClosedFrechet closed(P, Q);
+    double distance = closed.distance(parser.value(toleranceOption).toDouble());
+
+    QTextStream out(stdout);
+    out << "distance " << distance << Qt::endl;
+    out << "shift " << closed.bestShift() << Qt::endl;
+    for (const auto& p : closed.matching())
+        out << p.x() << " " << p.y() << Qt::endl;
+
+    return 0;
+}
+
+static int runCluster(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Gonzalez k-center clustering of a curve set under the Frechet distance.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Curve set file (a header line before each curve).");
+    QCommandLineOption kOption("k", "Number of clusters.", "count", "3");
+    QCommandLineOption verticesOption("center-vertices", "Simplify centers to at most this many vertices.", "count", "0");
+    parser.addOptions({kOption, verticesOption});
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1)
+        parser.showHelp(1);
+
+    std::vector<Polyline> curves;
+    if (!readCurveSet(args[0], curves))
+        return 1;
+
+    Frechet::KCenterClustering::Options options;
+    options.k = std::max(1, parser.value(kOption).toInt());
+    options.centerVertices = parser.value(verticesOption).toInt();
+    auto result = Frechet::KCenterClustering(curves, options).run();
+
+    QTextStream out(stdout);
+    out << "# " << curves.size() << " curves, " << result.decisions << " decisions, "
+        << result.distanceEvaluations << " distance evaluations" << Qt::endl;
+    for (size_t c = 0; c < result.centers.size(); ++c)
+        out << "cluster " << c << " center " << result.centers[c]
+            << " radius " << result.radii[c] << Qt::endl;
+    for (size_t i = 0; i < curves.size(); ++i)
+        out << i << " " << result.assignment[i] << " " << result.distance[i] << Qt::endl;
+
+    return 0;
+}
+
+static int runTranslate(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Frechet distance minimised over translations of Q.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Polyline file (P / Q format).");
+    QCommandLineOption deltaOption("delta", "Approximation factor (1 + delta).", "value", "0.01");
+    parser.addOption(deltaOption);
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1)
+        parser.showHelp(1);
+
+    Polyline P, Q;
+    if (!readPolylines(args[0], P, Q))
+        return 1;
+
+    auto result = Frechet::TranslationFrechet(P, Q).solve(parser.value(deltaOption).toDouble());
+
+    QTextStream out(stdout);
+    out << "distance " << result.distance << Qt::endl;
+    out << "translation " << result.translation.x() << " " << result.translation.y() << Qt::endl;
+    out << "# " << result.boxes << " boxes, " << result.evaluations << " evaluated" << Qt::endl;
+    for (const auto& p : result.matching)
+        out << p.x() << " " << p.y() << Qt::endl;
+
+    return 0;
+}
+
+static int runMatch(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Match a trace to the road graph path with minimum Frechet distance.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("graph", "Road graph file (v x y / e a b lines).");
+    parser.addPositionalArgument("trace", "Trace file (the first curve is used).");
+    QCommandLineOption toleranceOption("tolerance", "Relative bisection tolerance.", "value", "1e-3");
+    parser.addOption(toleranceOption);
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2)
+        parser.showHelp(1);
+
+    Frechet::RoadGraph graph;
+    std::vector<Polyline> traces;
+    if (!readRoadGraph(args[0], graph) || !readCurveSet(args[1], traces))
+        return 1;
+
+    Frechet::MapMatcher matcher(graph, traces.front());
+    auto match = matcher.match(parser.value(toleranceOption).toDouble());
+    if (!match.found) {
+        qWarning() << "No matching path";
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out << "distance " << match.eps << Qt::endl;
+    out << "vertices";
+    for (int v : match.vertices)
+        out << " " << v;
+    out << Qt::endl;
+    for (const auto& p : match.path)
+        out << p.x() << " " << p.y() << Qt::endl;
+
+    return 0;
+}
+
+static int runJoin(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("All pairs of curves from two sets within Frechet distance r.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("first", "Curve set A.");
+    parser.addPositionalArgument("second", "Curve set B.");
+    parser.addPositionalArgument("output", "Output file, one \"a b\" line per pair.");
+    QCommandLineOption radiusOption("radius", "Distance threshold r.", "value");
+    QCommandLineOption blockOption("block", "Curves of A verified per round.", "count", "1024");
+    parser.addOptions({radiusOption, blockOption});
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 3 || !parser.isSet(radiusOption))
+        parser.showHelp(1);
+
+    std::vector<Polyline> A, B;
+    if (!readCurveSet(args[0], A) || !readCurveSet(args[1], B))
+        return 1;
+
+    QFile file(args[2]);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Cannot write file:" << args[2];
+        return 1;
+    }
+
+    Frechet::SimilarityJoin::Options options;
+    options.radius = parser.value(radiusOption).toDouble();
+    options.blockSize = parser.value(blockOption).toInt();
+
+    // pairs go to the file as each block is verified
+    QTextStream pairs(&file);
+    pairs << "# d_F(a, b) <= " << options.radius << "\n";
+    auto stats = Frechet::SimilarityJoin(A, B, options).run([&](int a, int b) {
+        pairs << a << " " << b << "\n";
+    });
+    pairs.flush();
+    if (pairs.status() != QTextStream::Ok) {
+        qWarning() << "Cannot write file:" << args[2];
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out << "Wrote " << stats.matches << " pairs to " << args[2] << " (" << stats.candidates
+        << " candidates, " << stats.verified << " verified)" << Qt::endl;
+
+    return 0;
+}
+
+static int runSimplify(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simplify curves with a guaranteed Frechet error bound.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Curve set or polyline file.");
+    parser.addPositionalArgument("output", "Output curve set file.");
+    QCommandLineOption epsOption("eps", "Frechet error bound.", "value");
+    parser.addOption(epsOption);
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2 || !parser.isSet(epsOption))
+        parser.showHelp(1);
+
+    std::vector<Polyline> curves;
+    if (!readCurveSet(args[0], curves))
+        return 1;
+
+    double eps = parser.value(epsOption).toDouble();
+    std::vector<Polyline> simplified = Frechet::simplifyFrechet(curves, eps);
+
+    long long before = 0, after = 0;
+    QStringList comment = {QString("Frechet simplification, error <= %1").arg(eps, 0, 'g', 17)};
+    for (size_t c = 0; c < curves.size(); ++c) {
+        before += curves[c].size();
+        after += simplified[c].size();
+        comment << QString("curve %1: %2 -> %3 vertices").arg(c).arg(curves[c].size()).arg(simplified[c].size());
+    }
+
+    if (!writeCurveSet(args[1], simplified, comment.join('\n')))
+        return 1;
+
+    QTextStream out(stdout);
+    out << "Wrote " << simplified.size() << " curves (" << before << " -> " << after
+        << " vertices) to " << args[1] << Qt::endl;
+
+    return 0;
+}
+
+static int runNearest(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Approximate Frechet near-neighbour queries through an LSH index.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("collection", "Curve set to index.");
+    parser.addPositionalArgument("queries", "Curve set of queries.");
+    QCommandLineOption radiusOption("radius", "Query radius.", "value");
+    QCommandLineOption tablesOption("tables", "Number of hash tables.", "count", "8");
+    QCommandLineOption discreteOption("discrete", "Use the discrete Frechet distance.");
+    parser.addOptions({radiusOption, tablesOption, discreteOption});
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2 || !parser.isSet(radiusOption))
+        parser.showHelp(1);
+
+    std::vector<Polyline> collection, queries;
+    if (!readCurveSet(args[0], collection) || !readCurveSet(args[1], queries))
+        return 1;
+
+    Frechet::FrechetLSH::Options options;
+    options.radius = parser.value(radiusOption).toDouble();
+    options.tables = parser.value(tablesOption).toInt();
+    if (parser.isSet(discreteOption))
+        options.metric = Frechet::FrechetLSH::Metric::Discrete;
+
+    Frechet::FrechetLSH index(options);
+    for (auto& curve : collection)
+        index.add(makePolyline(std::move(curve)));
+    index.build();
+
+    // one line per query: query index and a curve within the radius, -1 if none
+    QTextStream out(stdout);
+    for (size_t q = 0; q < queries.size(); ++q)
+        out << q << " " << index.anyWithin(queries[q]) << Qt::endl;
+
+    return 0;
+}
+
+static int runOracle(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Answer many queries against one long reference curve.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("reference", "Curve set file, its first curve is the reference.");
+    parser.addPositionalArgument("queries", "Curve set of queries.");
+    QCommandLineOption errorOption("relative-error", "Relative error of the answers.", "value", "0.1");
+    QCommandLineOption epsOption("eps", "Decide against this threshold instead of estimating the distance.", "value");
+    parser.addOptions({errorOption, epsOption});
+    parser.process(arguments);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2)
+        parser.showHelp(1);
+
+    std::vector<Polyline> references, queries;
+    if (!readCurveSet(args[0], references) || !readCurveSet(args[1], queries))
+        return 1;
+    if (references.empty()) {
+        qWarning() << "No reference curve in" << args[0];
+        return 1;
+    }
+
+    // built once, every query reuses the hierarchy
+    Frechet::LongCurveOracle oracle(references.front());
+    double relativeError = parser.value(errorOption).toDouble();
+
+    // one line per query: the estimate and its error bound, or 1 / 0
+    // for within / beyond eps
+    QTextStream out(stdout);
+    for (size_t q = 0; q < queries.size(); ++q) {
+        if (parser.isSet(epsOption)) {
+            double eps = parser.value(epsOption).toDouble();
+            out << q << " " << (oracle.decide(queries[q], eps, relativeError) ? 1 : 0) << Qt::endl;
+        } else {
+            auto estimate = oracle.distance(queries[q], relativeError);
+            out << q << " " << estimate.distance << " " << estimate.error << Qt::endl;
+        }
+    }
+
+    return 0;
+}
+
+static const std::map<QString, Command>& commands()
+{
+    static const std::map<QString, Command> table = {
+        {"export", runExport},
+        {"closed", runClosed},
+        {"decide", runDecide},
+        {"distance", runDistance},
+        {"cluster", runCluster},
+        {"join", runJoin},
+        {"match", runMatch},
+        {"nearest", runNearest},
+        {"oracle", runOracle},
+        {"simplify", runSimplify},
+        {"translate", runTranslate},
+    };
+    return table;
+}
+
+bool isBatchCommand(int argc, char* argv[])
+{
+    return argc > 1 && commands().count(QString::fromLocal8Bit(argv[1])) > 0;
+}
+
+int run(int argc, char* argv[])
+{
+    // no display server needed for offscreen painting
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+
+    QStringList arguments = app.arguments();
+    QString command = arguments.takeAt(1);
+    arguments[0] += " " + command;
+
+    // accepted by every command
+    if (arguments.removeAll("--no-cache") > 0)
+        Frechet::ResultCache::instance().setEnabled(false);
+
+    int result = commands().at(command)(arguments);
+    Frechet::ResultCache::instance().flush();
+    return result;
+}
+
+} // namespace Batch
@@ -0,0 +1,13 @@
+#pragma once
+
+// Headless command line entry points, e.g.
+//   FrechetVisualizer export <input.txt> <directory> --eps 12
+namespace Batch {
+
+// true if the first argument names a batch command
+bool isBatchCommand(int argc, char* argv[]);
+
+// runs the command without a display server, returns the exit code
+int run(int argc, char* argv[]);
+
+} // namespace Batch
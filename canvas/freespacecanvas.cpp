@@ -76,12 +76,8 @@ void FreeSpaceCanvas::paintEvent(QPaintEvent*)
     if (!fs_)
         return;
 
-    int m = fs_->getM();
-    int n = fs_->getN();
-    int s = cellSize_;
-
-    int gridWidth  = m * s;
-    int gridHeight = n * s;
+    int gridWidth  = fs_->getM() * cellSize_;
+    int gridHeight = fs_->getN() * cellSize_;
 
     // center inside widget
     int offsetX = (width()  - gridWidth)  / 2;
@@ -89,19 +85,36 @@ void FreeSpaceCanvas::paintEvent(QPaintEvent*)
 
     p.save();
     p.translate(offsetX, offsetY);
+    paintDiagram(p, *fs_, cellSize_, QRect(-offsetX, -offsetY, width(), height()));
+    p.restore();
+}
+
+void FreeSpaceCanvas::paintDiagram(QPainter& p, const FreeSpace& fs, int s, const QRect& clip)
+{
+    int m = fs.getM();
+    int n = fs.getN();
+
+    int gridWidth  = m * s;
+    int gridHeight = n * s;
+
+    // only cells intersecting the clip rectangle (one cell of slack for pen widths)
+    int iBegin = std::max(0, clip.left() / s - 1);
+    int iEnd   = std::min(m, clip.right() / s + 2);
+    int jBegin = std::max(0, (gridHeight - clip.bottom()) / s - 1);
+    int jEnd   = std::min(n, (gridHeight - clip.top()) / s + 2);
 
     p.setPen(QPen(Qt::black, 1));
-    for (int i = 0; i <= m; ++i)
+    for (int i = iBegin; i <= iEnd; ++i)
         p.drawLine(i * s, 0, i * s, gridHeight);
 
-    for (int j = 0; j <= n; ++j)
+    for (int j = jBegin; j <= jEnd; ++j)
         p.drawLine(0, gridHeight - j * s, gridWidth, gridHeight - j * s);
 
     p.setPen(QPen(QColor("#0096FF"), 3));
-    const auto& cells = fs_->getCells();
+    const auto& cells = fs.getCells();
 
-    for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < n; ++j) {
+    for (int i = iBegin; i < iEnd; ++i) {
+        for (int j = jBegin; j < jEnd; ++j) {
             const auto& c = cells[i][j];
             int x = i * s;
             int y = gridHeight - (j + 1) * s; // bottom-left corner of cell
@@ -119,8 +132,8 @@ void FreeSpaceCanvas::paintEvent(QPaintEvent*)
 
     p.setPen(QPen(QColor("#10B981"), 4));
 
-    for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < n; ++j) {
+    for (int i = iBegin; i < iEnd; ++i) {
+        for (int j = jBegin; j < jEnd; ++j) {
             const auto& c = cells[i][j];
             int x = i * s;
             int y = gridHeight - (j + 1) * s;
@@ -136,12 +149,12 @@ void FreeSpaceCanvas::paintEvent(QPaintEvent*)
         }
     }
 
-    if (fs_->pathComputed && fs_->getEps() >= fs_->criticalEps) {
+    if (fs.pathComputed && fs.getEps() >= fs.criticalEps) {
         p.setPen(QPen(Qt::yellow, 2));
 
-        for (size_t k = 0; k + 1 < fs_->criticalPath.size(); ++k) {
-            const QPointF& p1 = fs_->criticalPath[k];
-            const QPointF& p2 = fs_->criticalPath[k+1];
+        for (size_t k = 0; k + 1 < fs.criticalPath.size(); ++k) {
+            const QPointF& p1 = fs.criticalPath[k];
+            const QPointF& p2 = fs.criticalPath[k+1];
 
             int x1 = static_cast<int>(p1.x() * s);
             int y1 = static_cast<int>(gridHeight - p1.y() * s);
@@ -159,7 +172,7 @@ void FreeSpaceCanvas::paintEvent(QPaintEvent*)
     p.setFont(font);
 
     // imena P segmenata
-    for (int i = 0; i < m; ++i) {
+    for (int i = iBegin; i < iEnd; ++i) {
         QString name = QString("P%1P%2").arg(subscriptNumber(i)).arg(subscriptNumber(i+1));
         int x = i * s + s/2;       // sredina ćelije horizontalno
         int y = gridHeight + 30;   // ispod donjih ivica
@@ -167,12 +180,10 @@ void FreeSpaceCanvas::paintEvent(QPaintEvent*)
     }
 
     // imena Q segmenata
-    for (int j = 0; j < n; ++j) {
+    for (int j = jBegin; j < jEnd; ++j) {
         QString name = QString("Q%1Q%2").arg(subscriptNumber(j)).arg(subscriptNumber(j+1));
         int x = -50;               // levo od najlevlje kolone
         int y = gridHeight - (j * s + s/2); // sredina ćelije vertikalno
         p.drawText(x, y + 5, name); // +5 da centriramo vertikalno
     }
-
-    p.restore();
 }
@@ -3,6 +3,8 @@
 #include <QWidget>
 #include "../geometry/freespace.h"
 
+class QPainter;
+
 class FreeSpaceCanvas : public QWidget
 {
     Q_OBJECT
@@ -14,6 +16,10 @@ public:
 
     void updateCellSize();
     static QString subscriptNumber(int n);
+
+    // Draws the diagram with its bottom-left grid corner at (0, gridHeight);
+    // shared by the widget and the offscreen exporter
+    static void paintDiagram(QPainter& p, const FreeSpace& fs, int cellSize, const QRect& clip);
 protected:
     void paintEvent(QPaintEvent* event) override;
 
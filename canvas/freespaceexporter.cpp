@@ -0,0 +1,89 @@
+#include "freespaceexporter.h"
+#include "freespacecanvas.h"
+#include <QDir>
+#include <QFontDatabase>
+#include <QImage>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QtConcurrent>
+#include <atomic>
+
+FreeSpaceExporter::FreeSpaceExporter(const FreeSpace& fs, const Options& options)
+    : fs_(fs)
+    , options_(options)
+{
+}
+
+QSize FreeSpaceExporter::imageSize() const
+{
+    return QSize(MarginLeft + fs_.getM() * options_.cellSize + MarginRight,
+                 MarginTop + fs_.getN() * options_.cellSize + MarginBottom);
+}
+
+void FreeSpaceExporter::render(QPainter& p, const QRect& area) const
+{
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.translate(-area.topLeft());
+    p.fillRect(area, options_.background);
+
+    p.translate(MarginLeft, MarginTop);
+    FreeSpaceCanvas::paintDiagram(p, fs_, options_.cellSize,
+                                  area.translated(-MarginLeft, -MarginTop));
+}
+
+int FreeSpaceExporter::exportTiles(const QString& directory) const
+{
+    if (!QDir().mkpath(directory))
+        return -1;
+
+    QSize size = imageSize();
+    int t = options_.tileSize;
+
+    QVector<QRect> tiles;
+    for (int y = 0; y < size.height(); y += t)
+        for (int x = 0; x < size.width(); x += t)
+            tiles.append(QRect(x, y, std::min(t, size.width() - x), std::min(t, size.height() - y)));
+
+    std::atomic<bool> ok(true);
+    auto renderTile = [&](const QRect& tile) {
+        QImage image(tile.size(), QImage::Format_ARGB32_Premultiplied);
+        QPainter p(&image);
+        render(p, tile);
+        p.end();
+
+        QString name = QString("tile_%1_%2.png").arg(tile.y() / t).arg(tile.x() / t);
+        if (!image.save(QDir(directory).filePath(name)))
+            ok = false;
+    };
+
+    // text drawing off the GUI thread needs platform support
+    if (QFontDatabase::supportsThreadedFontRendering())
+        QtConcurrent::blockingMap(tiles, renderTile);
+    else
+        for (const QRect& tile : tiles)
+            renderTile(tile);
+
+    return ok ? tiles.size() : -1;
+}
+
+bool FreeSpaceExporter::exportPdf(const QString& fileName) const
+{
+    QSize size = imageSize();
+
+    // PDF viewers cap pages at 200 inches, larger diagrams are scaled down
+    const double maxPoints = 14400.0;
+    double scale = std::min(1.0, maxPoints / std::max(size.width(), size.height()));
+
+    QPdfWriter writer(fileName);
+    writer.setResolution(72); // one pixel per point
+    writer.setPageMargins(QMarginsF(0, 0, 0, 0));
+    writer.setPageSize(QPageSize(QSizeF(size.width() * scale, size.height() * scale), QPageSize::Point));
+
+    QPainter p;
+    if (!p.begin(&writer))
+        return false;
+
+    p.scale(scale, scale);
+    render(p, QRect(QPoint(0, 0), size));
+    return p.end();
+}
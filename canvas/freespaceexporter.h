@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QColor>
+#include <QRect>
+#include <QString>
+#include "../geometry/freespace.h"
+
+class QPainter;
+
+// Offscreen rendering of a free space diagram, independent of any widget
+// size and of a display server (draws through FreeSpaceCanvas::paintDiagram)
+class FreeSpaceExporter
+{
+public:
+    struct Options {
+        int cellSize = 50;
+        int tileSize = 2048;
+        QColor background = QColor("#202020"); // segment labels are white
+    };
+
+    explicit FreeSpaceExporter(const FreeSpace& fs, const Options& options = Options());
+
+    // whole image including the segment labels
+    QSize imageSize() const;
+
+    // PNG tiles "tile_<row>_<column>.png", rendered in parallel with one
+    // tile-sized image per worker; returns the tile count or -1 on failure
+    int exportTiles(const QString& directory) const;
+
+    // single-page vector PDF
+    bool exportPdf(const QString& fileName) const;
+
+private:
+    const FreeSpace& fs_;
+    Options options_;
+
+    static constexpr int MarginLeft = 60;
+    static constexpr int MarginTop = 10;
+    static constexpr int MarginRight = 10;
+    static constexpr int MarginBottom = 45;
+
+    void render(QPainter& p, const QRect& area) const;
+};
@@ -4,7 +4,8 @@
 #include <QPainterPath>
 #include <QTimer>
 #include <QFileDialog>
-#include <QRegularExpression>
+#include <algorithm>
+#include "../geometry/polylineio.h"
 
 PolylineCanvas::PolylineCanvas(QWidget *parent)
     : QWidget{parent}
@@ -74,8 +75,8 @@ void PolylineCanvas::generateAnimationPositions(const std::vector<QPointF>& crit
             double sParam = (1 - t) * a.x() + t * b.x();
             double qParam = (1 - t) * a.y() + t * b.y();
 
-            Point dogPos = pointOnPolyline(P, sParam);
-            Point humanPos = pointOnPolyline(Q, qParam);
+            Point dogPos = pointOnPolyline(*P, sParam);
+            Point humanPos = pointOnPolyline(*Q, qParam);
 
             dogPositions.push_back(transformPoint(dogPos));
             humanPositions.push_back(transformPoint(humanPos));
@@ -99,33 +100,36 @@ void PolylineCanvas::startAnimation()
 void PolylineCanvas::updateAnimation()
 {
     if (animIndex < static_cast<int>(dogPositions.size())) {
+        QRect dirty = animationRect();
         currentDogPos = dogPositions[animIndex];
         currentHumanPos = humanPositions[animIndex];
         currentLeashLength = leashLengths[animIndex];
         ++animIndex;
-        update();
+        update(dirty.united(animationRect()));
     } else {
         animTimer->stop();
     }
 }
 
 
-void PolylineCanvas::setPolylines(const Polyline& p, const Polyline& q) {
-    P = p;
-    Q = q;
+void PolylineCanvas::setPolylines(PolylinePtr p, PolylinePtr q) {
+    P = std::move(p);
+    Q = std::move(q);
+    layersValid_ = false;
+    staticLayerValid_ = false;
     updateTransform();
 
-    if (!P.vertices.empty())
-        currentDogPos = transformPoint(P.vertices[0]);
-    if (!Q.vertices.empty())
-        currentHumanPos = transformPoint(Q.vertices[0]);
+    if (!P->vertices.empty())
+        currentDogPos = transformPoint(P->vertices[0]);
+    if (!Q->vertices.empty())
+        currentHumanPos = transformPoint(Q->vertices[0]);
 
     update();
 }
 
 void PolylineCanvas::updateTransform()
 {
-    if (P.vertices.empty() || Q.vertices.empty()) return;
+    if (P->vertices.empty() || Q->vertices.empty()) return;
 
     bbox_ = computeBoundingBox();
 
@@ -139,6 +143,9 @@ void PolylineCanvas::updateTransform()
 
     offsetX_ = margin - bbox_.minX * scale_;
     offsetY_ = margin + bbox_.maxY * scale_;
+
+    layersValid_ = false;
+    staticLayerValid_ = false;
 }
 
 
@@ -150,11 +157,71 @@ QPointF PolylineCanvas::transformPoint(const Point& pt) const
 }
 
 constexpr double MARKER_RADIUS = 3.0;
+// how far, in pixels, each simplification pass may move the drawn curve
+constexpr double LOD_TOLERANCE = 0.5;
 
 void PolylineCanvas::paintEvent(QPaintEvent*)
 {
+    if (!staticLayerValid_ || staticLayer_.size() != size() * devicePixelRatioF())
+        rebuildStaticLayer();
+
     QPainter painter(this);
+
+    // Qt clips this to the dirty region, so animation frames only
+    // blit the part of the cached layer under the moving sprites
+    painter.drawPixmap(0, 0, staticLayer_);
+
+    if (P->vertices.empty() || Q->vertices.empty())
+        return;
+
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    if (!dogPixmap.isNull() && dogPixmapScaled.isNull()) {
+        double pixScale = 0.05 * width() / dogPixmap.width();
+        dogPixmapScaled = dogPixmap.scaled(dogPixmap.width()*pixScale,
+                                           dogPixmap.height()*pixScale,
+                                           Qt::KeepAspectRatio,
+                                           Qt::SmoothTransformation);
+    }
+
+    if (!humanPixmap.isNull() && humanPixmapScaled.isNull()) {
+        double pixScale = 0.05 * width() / humanPixmap.width();
+        humanPixmapScaled = humanPixmap.scaled(humanPixmap.width()*pixScale,
+                                               humanPixmap.height()*pixScale,
+                                               Qt::KeepAspectRatio,
+                                               Qt::SmoothTransformation);
+    }
+
+    // leash drawing -> a bit translated so it fits the hand of a man and a collar of a dog
+    if (currentDogPos != transformPoint(P->vertices[0]) || currentHumanPos != transformPoint(Q->vertices[0])) {
+        QPen leashPen(QColor(255, 170, 0));
+        leashPen.setWidth(2);
+        painter.setPen(leashPen);
+        painter.drawLine(QPointF(currentDogPos.x() + 2, currentDogPos.y()), QPointF(currentHumanPos.x() + 11, currentHumanPos.y()));
+
+        drawLeashLength(painter);
+    }
+
+    if (!dogPixmapScaled.isNull())
+        painter.drawPixmap(currentDogPos.x() - dogPixmapScaled.width()/2,
+                           currentDogPos.y() - dogPixmapScaled.height()/2,
+                           dogPixmapScaled);
+
+    if (!humanPixmapScaled.isNull())
+        painter.drawPixmap(currentHumanPos.x() - humanPixmapScaled.width()/2,
+                           currentHumanPos.y() - humanPixmapScaled.height()/2,
+                           humanPixmapScaled);
+}
+
+void PolylineCanvas::rebuildStaticLayer()
+{
+    staticLayer_ = QPixmap(size() * devicePixelRatioF());
+    staticLayer_.setDevicePixelRatio(devicePixelRatioF());
+    staticLayer_.fill(Qt::transparent);
+
+    QPainter painter(&staticLayer_);
     painter.setRenderHint(QPainter::Antialiasing);
+    painter.setFont(font());
 
     QPainterPath bg;
     bg.addRoundedRect(rect().adjusted(2, 2, -2, -2), 12, 12);
@@ -163,20 +230,21 @@ void PolylineCanvas::paintEvent(QPaintEvent*)
     painter.setPen(QPen(QColor("#E5E7EB"), 1));
     painter.drawPath(bg);
 
+    staticLayerValid_ = true;
 
-    if (P.vertices.empty() || Q.vertices.empty())
+    if (P->vertices.empty() || Q->vertices.empty())
         return;
 
+    if (!layersValid_)
+        rebuildLayers();
+
     // --- crtanje linija ---
+    painter.setBrush(Qt::NoBrush);
     painter.setPen(QPen(QColor("#2563EB"), 2));
-    for (int i = 0; i + 1 < P.vertices.size(); ++i)
-        painter.drawLine(transformPoint(P.vertices[i]),
-                         transformPoint(P.vertices[i + 1]));
+    painter.drawPath(layerP_.path);
 
     painter.setPen(QPen(QColor("#DC2626"), 2));
-    for (int i = 0; i + 1 < Q.vertices.size(); ++i)
-        painter.drawLine(transformPoint(Q.vertices[i]),
-                         transformPoint(Q.vertices[i + 1]));
+    painter.drawPath(layerQ_.path);
 
     QFont font = painter.font();
     font.setPointSizeF(12);
@@ -184,55 +252,161 @@ void PolylineCanvas::paintEvent(QPaintEvent*)
 
     painter.setPen(QColor("#2563EB"));
     painter.setBrush(QColor("#2563EB"));
-    for (size_t i = 0; i < P.vertices.size(); ++i) {
-        QPointF pt = transformPoint(P.vertices[i]);
+    for (int i : layerP_.labelled) {
+        QPointF pt = transformPoint(P->vertices[i]);
         painter.drawText(pt + QPointF(5, -5), QString("P%1").arg(FreeSpaceCanvas::subscriptNumber(i)));
         painter.drawEllipse(pt, MARKER_RADIUS, MARKER_RADIUS);
     }
 
     painter.setPen(QColor("#DC2626"));
     painter.setBrush(QColor("#DC2626"));
-    for (size_t i = 0; i < Q.vertices.size(); ++i) {
-        QPointF pt = transformPoint(Q.vertices[i]);
+    for (int i : layerQ_.labelled) {
+        QPointF pt = transformPoint(Q->vertices[i]);
         painter.drawText(pt + QPointF(5, -5), QString("Q%1").arg(FreeSpaceCanvas::subscriptNumber(i)));
         painter.drawEllipse(pt, MARKER_RADIUS, MARKER_RADIUS);
     }
+}
 
-    if (!dogPixmap.isNull() && dogPixmapScaled.isNull()) {
-        double pixScale = 0.05 * width() / dogPixmap.width();
-        dogPixmapScaled = dogPixmap.scaled(dogPixmap.width()*pixScale,
-                                           dogPixmap.height()*pixScale,
-                                           Qt::KeepAspectRatio,
-                                           Qt::SmoothTransformation);
-    }
+QRect PolylineCanvas::animationRect() const
+{
+    // sprites, leash and the length label around the midpoint
+    QRect r = QRectF(currentDogPos, currentHumanPos).normalized().toAlignedRect();
+    r = r.united(QRect(currentDogPos.toPoint(), dogPixmapScaled.size())
+                     .translated(-dogPixmapScaled.width() / 2, -dogPixmapScaled.height() / 2));
+    r = r.united(QRect(currentHumanPos.toPoint(), humanPixmapScaled.size())
+                     .translated(-humanPixmapScaled.width() / 2, -humanPixmapScaled.height() / 2));
+    QPoint mid = (0.5 * (currentDogPos + currentHumanPos)).toPoint();
+    r = r.united(QRect(mid - QPoint(40, 15), QSize(80, 30)));
+    return r.adjusted(-15, -5, 15, 5);
+}
 
-    if (!humanPixmap.isNull() && humanPixmapScaled.isNull()) {
-        double pixScale = 0.05 * width() / humanPixmap.width();
-        humanPixmapScaled = humanPixmap.scaled(humanPixmap.width()*pixScale,
-                                               humanPixmap.height()*pixScale,
-                                               Qt::KeepAspectRatio,
-                                               Qt::SmoothTransformation);
+void PolylineCanvas::resizeEvent(QResizeEvent*)
+{
+    staticLayerValid_ = false;
+    layersValid_ = false;
+}
+
+void PolylineCanvas::rebuildLayers()
+{
+    // labels of both curves share one occupancy grid
+    std::vector<char> occupied;
+    layerP_ = buildLayer(*P, "P", occupied);
+    layerQ_ = buildLayer(*Q, "Q", occupied);
+    layersValid_ = true;
+}
+
+PolylineCanvas::CurveLayer PolylineCanvas::buildLayer(const Polyline& poly,
+                                                      const QString& prefix,
+                                                      std::vector<char>& occupied) const
+{
+    CurveLayer layer;
+    if (poly.vertices.empty())
+        return layer;
+
+    std::vector<QPointF> screen(poly.vertices.size());
+    for (size_t i = 0; i < screen.size(); ++i)
+        screen[i] = transformPoint(poly.vertices[i]);
+
+    // radial pass: drop vertices within the tolerance of the last kept one,
+    // which collapses dense runs in O(n) whatever direction they go in
+    const double tolerance = LOD_TOLERANCE;
+    const double tolerance2 = tolerance * tolerance;
+    std::vector<size_t> kept{0};
+    for (size_t i = 1; i < screen.size(); ++i) {
+        QPointF d = screen[i] - screen[kept.back()];
+        if (d.x() * d.x() + d.y() * d.y() > tolerance2 || i + 1 == screen.size())
+            kept.push_back(i);
     }
 
-    // leash drawing -> a bit translated so it fits the hand of a man and a collar of a dog
-    if (currentDogPos != transformPoint(P.vertices[0]) || currentHumanPos != transformPoint(Q.vertices[0])) {
-        QPen leashPen(QColor(255, 170, 0));
-        leashPen.setWidth(2);
-        painter.setPen(leashPen);
-        painter.drawLine(QPointF(currentDogPos.x() + 2, currentDogPos.y()), QPointF(currentHumanPos.x() + 11, currentHumanPos.y()));
+    // Douglas-Peucker on what is left: a vertex stays only if it is more
+    // than the tolerance away from the chord of its span
+    std::vector<char> keep(kept.size(), 0);
+    keep.front() = keep.back() = 1;
+    std::vector<std::pair<size_t, size_t>> spans;
+    if (kept.size() > 2)
+        spans.emplace_back(0, kept.size() - 1);
+    while (!spans.empty()) {
+        auto [first, last] = spans.back();
+        spans.pop_back();
+
+        const QPointF& a = screen[kept[first]];
+        QPointF ab = screen[kept[last]] - a;
+        double ab2 = ab.x() * ab.x() + ab.y() * ab.y();
+        double worst = tolerance2;
+        size_t split = first;
+        for (size_t k = first + 1; k < last; ++k) {
+            QPointF ap = screen[kept[k]] - a;
+            double t = ab2 > 0.0 ? std::clamp((ap.x() * ab.x() + ap.y() * ab.y()) / ab2, 0.0, 1.0) : 0.0;
+            QPointF d = ap - t * ab;
+            double d2 = d.x() * d.x() + d.y() * d.y();
+            if (d2 > worst) {
+                worst = d2;
+                split = k;
+            }
+        }
+        if (split == first)
+            continue;
 
-        drawLeashLength(painter);
+        keep[split] = 1;
+        if (split - first > 1)
+            spans.emplace_back(first, split);
+        if (last - split > 1)
+            spans.emplace_back(split, last);
     }
 
-    if (!dogPixmapScaled.isNull())
-        painter.drawPixmap(currentDogPos.x() - dogPixmapScaled.width()/2,
-                           currentDogPos.y() - dogPixmapScaled.height()/2,
-                           dogPixmapScaled);
+    layer.path.moveTo(screen.front());
+    for (size_t k = 1; k < kept.size(); ++k)
+        if (keep[k])
+            layer.path.lineTo(screen[kept[k]]);
 
-    if (!humanPixmapScaled.isNull())
-        painter.drawPixmap(currentHumanPos.x() - humanPixmapScaled.width()/2,
-                           currentHumanPos.y() - humanPixmapScaled.height()/2,
-                           humanPixmapScaled);
+    // labels are kept only where they do not overlap earlier ones,
+    // so their number is bounded by the widget area
+    const int grid = 8;
+    int gw = width() / grid + 1;
+    int gh = height() / grid + 1;
+    occupied.resize(static_cast<size_t>(gw) * gh, 0);
+
+    QFont f = font();
+    f.setPointSizeF(12);
+    QFontMetrics fm(f);
+
+    for (size_t i = 0; i < screen.size(); ++i) {
+        const QPointF& pt = screen[i];
+
+        // the marker covers the anchor's cell: if that is taken, the label
+        // cannot fit and the text is never formatted or measured
+        int ax = static_cast<int>(std::floor(pt.x() / grid));
+        int ay = static_cast<int>(std::floor(pt.y() / grid));
+        if (ax >= 0 && ax < gw && ay >= 0 && ay < gh && occupied[ay * gw + ax])
+            continue;
+
+        QRect box = fm.boundingRect(QString("%1%2").arg(prefix, FreeSpaceCanvas::subscriptNumber(i)));
+        box.moveBottomLeft((pt + QPointF(5, -5)).toPoint());
+        int marker = static_cast<int>(2 * MARKER_RADIUS);
+        box = box.united(QRect((pt - QPointF(MARKER_RADIUS, MARKER_RADIUS)).toPoint(),
+                               QSize(marker, marker)));
+
+        int x0 = std::max(0, box.left() / grid);
+        int x1 = std::min(gw - 1, box.right() / grid);
+        int y0 = std::max(0, box.top() / grid);
+        int y1 = std::min(gh - 1, box.bottom() / grid);
+        if (x0 > x1 || y0 > y1)
+            continue;
+
+        bool free = true;
+        for (int y = y0; y <= y1 && free; ++y)
+            for (int x = x0; x <= x1 && free; ++x)
+                free = !occupied[y * gw + x];
+        if (!free)
+            continue;
+
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x)
+                occupied[y * gw + x] = 1;
+        layer.labelled.push_back(static_cast<int>(i));
+    }
+
+    return layer;
 }
 
 void PolylineCanvas::drawLeashLength(QPainter &painter)
@@ -278,8 +452,8 @@ PolylineCanvas::BoundingBox PolylineCanvas::computeBoundingBox() const
         if (pt.y() > bb.maxY) bb.maxY = pt.y();
     };
 
-    for (const auto& p : P.vertices) update(p);
-    for (const auto& q : Q.vertices) update(q);
+    for (const auto& p : P->vertices) update(p);
+    for (const auto& q : Q->vertices) update(q);
 
     return bb;
 }
@@ -301,10 +475,10 @@ void PolylineCanvas::resetAnimation()
     leashLengths.clear();
     animIndex = 0;
 
-    if (!P.vertices.empty())
-        currentDogPos = transformPoint(P.vertices[0]);
-    if (!Q.vertices.empty())
-        currentHumanPos = transformPoint(Q.vertices[0]);
+    if (!P->vertices.empty())
+        currentDogPos = transformPoint(P->vertices[0]);
+    if (!Q->vertices.empty())
+        currentHumanPos = transformPoint(Q->vertices[0]);
 
     currentLeashLength = 0.0;
 
@@ -318,65 +492,12 @@ void PolylineCanvas::loadPolylines()
     if (fileName.isEmpty())
         return;
 
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Cannot open file:" << fileName;
-        return;
-    }
-
-    QTextStream in(&file);
-
     Polyline newP, newQ;
-    Polyline* current = nullptr;
-
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-
-        if (line.isEmpty())
-            continue;
-
-        if (line == "P") {
-            current = &newP;
-            continue;
-        }
-
-        if (line == "Q") {
-            current = &newQ;
-            continue;
-        }
-
-        if (!current) {
-            qWarning() << "Point without polyline header:" << line;
-            continue;
-        }
-
-        QStringList parts = line.split(QRegularExpression("\\s+"));
-        if (parts.size() != 2) {
-            qWarning() << "Invalid line:" << line;
-            continue;
-        }
-
-        bool okX, okY;
-        double x = parts[0].toDouble(&okX);
-        double y = parts[1].toDouble(&okY);
-
-        if (!okX || !okY) {
-            qWarning() << "Invalid coordinates:" << line;
-            continue;
-        }
-
-        current->vertices.emplace_back(x, y);
-    }
-
-    if (newP.vertices.size() < 2 || newQ.vertices.size() < 2) {
-        qWarning() << "Each polyline must have at least 2 points";
+    if (!readPolylines(fileName, newP, newQ))
         return;
-    }
-
-    setPolylines(newP, newQ);
 
-    file.close();
+    // from here on the vertices are shared, never copied
+    setPolylines(makePolyline(std::move(newP)), makePolyline(std::move(newQ)));
 
     emit polylinesLoaded(P, Q);
 }
-
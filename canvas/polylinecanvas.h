@@ -2,6 +2,7 @@
 #define POLYLINECANVAS_H
 
 #include <QWidget>
+#include <QPainterPath>
 #include "../geometry/Polyline.h"
 
 class PolylineCanvas : public QWidget
@@ -15,7 +16,7 @@ public:
     };
 
     explicit PolylineCanvas(QWidget *parent = nullptr);
-    void setPolylines(const Polyline& p, const Polyline& q);
+    void setPolylines(PolylinePtr p, PolylinePtr q);
     void updateTransform();
 
     QPointF transformPoint(const Point &pt) const;
@@ -29,10 +30,11 @@ public:
     void resetAnimation();
 protected:
     void paintEvent(QPaintEvent *) override;
+    void resizeEvent(QResizeEvent *) override;
 
 private:
-    Polyline P;
-    Polyline Q;
+    PolylinePtr P = makePolyline();
+    PolylinePtr Q = makePolyline();
 
     double scale_ = 1.0;
     double offsetX_ = 0.0;
@@ -40,6 +42,20 @@ private:
 
     BoundingBox bbox_; 
 
+    // Level-of-detail cache for the current transform: the curve simplified
+    // to pixel tolerance and the vertices whose labels fit
+    struct CurveLayer {
+        QPainterPath path;
+        std::vector<int> labelled;
+    };
+    CurveLayer layerP_, layerQ_;
+    bool layersValid_ = false;
+
+    // background, curves and labels; invalidated only on resize or load,
+    // animation frames draw the sprites on top of it
+    QPixmap staticLayer_;
+    bool staticLayerValid_ = false;
+
     // Animation info
     QPixmap dogPixmap, dogPixmapScaled;
     QPixmap humanPixmap, humanPixmapScaled;
@@ -55,6 +71,10 @@ private:
     QTimer* animTimer = nullptr;
 
     BoundingBox computeBoundingBox() const;
+    void rebuildLayers();
+    void rebuildStaticLayer();
+    QRect animationRect() const;
+    CurveLayer buildLayer(const Polyline& poly, const QString& prefix, std::vector<char>& occupied) const;
     void drawLeashLength(QPainter &painter);
 
 public slots:
@@ -62,7 +82,7 @@ public slots:
     void loadPolylines();
 
 signals:
-    void polylinesLoaded(const Polyline& P, const Polyline& Q);
+    void polylinesLoaded(PolylinePtr P, PolylinePtr Q);
 
 };
 
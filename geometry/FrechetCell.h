@@ -36,7 +36,7 @@ struct Interval {
     bool isEmpty() const { return empty; }
 
     bool contains(double a) const {
-        return start <= a && a <= end;
+        return !empty && start <= a && a <= end;
     }
 
     QString toString() const {
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include <vector>
 #include "Point.h"
 
@@ -11,3 +12,32 @@ public:
 
     int size() const { return static_cast<int>(vertices.size()); }
 };
+
+// Shared immutable curve: copies only bump a reference count, so the
+// canvases, FreeSpace and the batch engines can hold the same vertices.
+// Create through makePolyline so detach() may hand out a mutable copy.
+using PolylinePtr = std::shared_ptr<const Polyline>;
+
+inline PolylinePtr makePolyline(Polyline p = Polyline())
+{
+    return std::make_shared<Polyline>(std::move(p));
+}
+
+// Copy-on-write access for the owner of a PolylinePtr
+inline Polyline& detach(PolylinePtr& p)
+{
+    if (!p)
+        p = makePolyline();
+    else if (p.use_count() > 1)
+        p = makePolyline(*p);
+    return const_cast<Polyline&>(*p);
+}
+
+// Overwrite p's vertices, reusing its storage when it is not shared
+inline void assignPolyline(PolylinePtr& p, const Polyline& src)
+{
+    if (p && p.use_count() == 1)
+        const_cast<Polyline&>(*p) = src;
+    else
+        p = makePolyline(src);
+}
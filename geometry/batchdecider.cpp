@@ -0,0 +1,275 @@
+#include "batchdecider.h"
+#include "decider.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Frechet {
+
+// same arithmetic as segmentPointInterval
+inline void BatchDecider::freeInterval(const Edge& edge, const Point& A, const Point& B, const Point& C,
+                                       const DistanceFilter& filter, double& lo, double& hi)
+{
+    bool startFree = filter.compare(edge.c0, A, C) <= 0;
+    bool endFree = filter.compare(edge.c1, B, C) <= 0;
+    Interval I = solveFreeInterval(edge.a, edge.b, edge.c0 - filter.e2, startFree, endFree);
+    lo = I.isEmpty() ? 1.0 : I.start;
+    hi = I.isEmpty() ? 0.0 : I.end;
+}
+
+inline void BatchDecider::freeInterval(const Edge& edge, const Point& A, const Point& B, const Point& C,
+                                       const DistanceFilter& filter, double disc, double root,
+                                       double& lo, double& hi)
+{
+    bool startFree = filter.compare(edge.c0, A, C) <= 0;
+    bool endFree = filter.compare(edge.c1, B, C) <= 0;
+    Interval I = solveFreeInterval(edge.a, edge.b, edge.c0 - filter.e2, disc, root, startFree, endFree);
+    lo = I.isEmpty() ? 1.0 : I.start;
+    hi = I.isEmpty() ? 0.0 : I.end;
+}
+
+void BatchDecider::roots(const Edge& edge, double* disc, double* root) const
+{
+    // no branches or calls: max(d, 0) keeps the square root in its domain
+    int K = static_cast<int>(e2_.size());
+    const double* e2 = e2_.data();
+    for (int k = 0; k < K; ++k) {
+        double d = edge.b * edge.b - 4.0 * edge.a * (edge.c0 - e2[k]);
+        disc[k] = d;
+        root[k] = std::sqrt(std::max(d, 0.0));
+    }
+}
+
+BatchDecider::BatchDecider(const Polyline& P, const Polyline& Q)
+    : P_(P), Q_(Q)
+{
+}
+
+BatchDecider::Edge BatchDecider::edge(const Point& A, const Point& B, const Point& C)
+{
+    Point d = B - A;
+    Point f = A - C;
+    Point g = B - C;
+    return {d.x() * d.x() + d.y() * d.y(),
+            2.0 * (d.x() * f.x() + d.y() * f.y()),
+            f.x() * f.x() + f.y() * f.y(),
+            g.x() * g.x() + g.y() * g.y()};
+}
+
+std::vector<char> BatchDecider::decide(const std::vector<double>& eps)
+{
+    int K = static_cast<int>(eps.size());
+    std::vector<char> result(K, 0);
+    if (K == 0)
+        return result;
+
+    ++passes_;
+    int m = P_.size() - 1;
+    int n = Q_.size() - 1;
+
+    // a single vertex has no grid, the cascade is exact there
+    if (m < 1 || n < 1) {
+        Decider decider(P_, Q_);
+        decider.setCacheEnabled(false); // bisection steps, not worth persisting
+        for (int k = 0; k < K; ++k)
+            result[k] = decider.decide(eps[k]).withinEps;
+        return result;
+    }
+
+    filters_.clear();
+    e2_.resize(K);
+    for (int k = 0; k < K; ++k) {
+        filters_.emplace_back(eps[k]);
+        e2_[k] = filters_[k].e2;
+    }
+    topDisc_.resize(K);
+    topRoot_.resize(K);
+    rightDisc_.resize(K);
+    rightRoot_.resize(K);
+
+    firstColumn_.resize(n);
+    leftLo_.assign(static_cast<size_t>(n) * K, 1.0);
+    leftHi_.assign(static_cast<size_t>(n) * K, 0.0);
+    bottomLo_.resize(K);
+    bottomHi_.resize(K);
+    chainLo_.resize(K);
+    chainHi_.resize(K);
+
+    const auto& p = P_.vertices;
+    const auto& q = Q_.vertices;
+
+    // left column of the grid: reachable while the free intervals chain up from (0,0)
+    for (int j = 0; j < n; ++j)
+        firstColumn_[j] = edge(q[j], q[j + 1], p[0]);
+
+    for (int k = 0; k < K; ++k) {
+        bool alive = true;
+        for (int j = 0; j < n; ++j) {
+            double lo, hi;
+            freeInterval(firstColumn_[j], q[j], q[j + 1], p[0], filters_[k], lo, hi);
+            size_t at = static_cast<size_t>(j) * K + k;
+            if (alive && lo <= hi && lo == 0.0) {
+                leftLo_[at] = lo;
+                leftHi_[at] = hi;
+                alive = hi >= 1.0;
+            } else {
+                alive = false;
+            }
+        }
+        chainLo_[k] = 0.0; // bottom row chain starts at (0,0)
+        chainHi_[k] = 0.0;
+    }
+
+    for (int i = 0; i < m; ++i) {
+        // bottom of (i, 0): continues the chain along Q[0]
+        Edge b0 = edge(p[i], p[i + 1], q[0]);
+        for (int k = 0; k < K; ++k) {
+            double lo, hi;
+            freeInterval(b0, p[i], p[i + 1], q[0], filters_[k], lo, hi);
+            bool chained = chainLo_[k] <= chainHi_[k] && (i == 0 ? chainLo_[k] == 0.0 : chainHi_[k] >= 1.0);
+            if (chained && lo <= hi && lo == 0.0) {
+                bottomLo_[k] = lo;
+                bottomHi_[k] = hi;
+            } else {
+                bottomLo_[k] = 1.0;
+                bottomHi_[k] = 0.0;
+            }
+            chainLo_[k] = bottomLo_[k];
+            chainHi_[k] = bottomHi_[k];
+        }
+
+        bool anyAlive = false;
+        for (int j = 0; j < n; ++j) {
+            double* leftLo = &leftLo_[static_cast<size_t>(j) * K];
+            double* leftHi = &leftHi_[static_cast<size_t>(j) * K];
+
+            // no lane enters the cell: its top and right stay empty, and the
+            // edges are only built for the band the lanes actually reach
+            bool entered = false;
+            for (int k = 0; k < K && !entered; ++k)
+                entered = leftLo[k] <= leftHi[k] || bottomLo_[k] <= bottomHi_[k];
+            if (!entered)
+                continue;
+
+            Edge top = edge(p[i], p[i + 1], q[j + 1]);
+            Edge right = edge(q[j], q[j + 1], p[i + 1]);
+            roots(top, topDisc_.data(), topRoot_.data());
+            roots(right, rightDisc_.data(), rightRoot_.data());
+
+            for (int k = 0; k < K; ++k) {
+                bool hasLeft = leftLo[k] <= leftHi[k];
+                bool hasBottom = bottomLo_[k] <= bottomHi_[k];
+
+                double tLo = 1.0, tHi = 0.0, rLo = 1.0, rHi = 0.0;
+                if (hasLeft || hasBottom) {
+                    freeInterval(top, p[i], p[i + 1], q[j + 1], filters_[k], topDisc_[k], topRoot_[k], tLo, tHi);
+                    freeInterval(right, q[j], q[j + 1], p[i + 1], filters_[k], rightDisc_[k], rightRoot_[k], rLo, rHi);
+
+                    // left reaches the whole top, bottom only from its start on
+                    if (!hasLeft)
+                        tLo = std::max(tLo, bottomLo_[k]);
+                    // bottom reaches the whole right side, left only from its start on
+                    if (!hasBottom)
+                        rLo = std::max(rLo, leftLo[k]);
+                }
+
+                bottomLo_[k] = tLo;
+                bottomHi_[k] = tHi;
+                leftLo[k] = rLo;
+                leftHi[k] = rHi;
+                anyAlive = anyAlive || tLo <= tHi || rLo <= rHi;
+            }
+        }
+
+        if (i == m - 1) {
+            const double* lastLo = &leftLo_[static_cast<size_t>(n - 1) * K];
+            const double* lastHi = &leftHi_[static_cast<size_t>(n - 1) * K];
+            for (int k = 0; k < K; ++k) {
+                bool topOk = bottomLo_[k] <= 1.0 && 1.0 <= bottomHi_[k];
+                bool rightOk = lastLo[k] <= 1.0 && 1.0 <= lastHi[k];
+                result[k] = topOk || rightOk;
+            }
+        }
+
+        // every lane is cut off, nothing later can be reached
+        if (!anyAlive)
+            break;
+    }
+
+    return result;
+}
+
+double BatchDecider::smallestAccepted(const std::vector<double>& candidates, int lanes)
+{
+    if (candidates.empty())
+        return 0.0;
+
+    lanes = std::max(1, lanes);
+    int lo = 0;
+    int hi = static_cast<int>(candidates.size()) - 1;
+
+    // each pass splits [lo, hi) into lanes + 1 parts
+    std::vector<int> probes;
+    std::vector<double> eps;
+    while (lo < hi) {
+        probes.clear();
+        eps.clear();
+        int span = hi - lo;
+        for (int k = 1; k <= lanes; ++k) {
+            int index = lo + static_cast<int>(static_cast<long long>(span) * k / (lanes + 1));
+            if (index >= hi || (!probes.empty() && probes.back() == index))
+                continue;
+            probes.push_back(index);
+            eps.push_back(candidates[index] * (1.0 + 1e-12) + 1e-12);
+        }
+        if (probes.empty())
+            probes.push_back(lo), eps.push_back(candidates[lo] * (1.0 + 1e-12) + 1e-12);
+
+        std::vector<char> accepted = decide(eps);
+
+        // decisions are monotone in eps: the first accepted probe bounds from above
+        int first = static_cast<int>(probes.size());
+        for (int k = 0; k < static_cast<int>(probes.size()); ++k) {
+            if (accepted[k]) {
+                first = k;
+                break;
+            }
+        }
+
+        int newLo = first > 0 ? probes[first - 1] + 1 : lo;
+        int newHi = first < static_cast<int>(probes.size()) ? probes[first] : hi;
+        lo = newLo;
+        hi = newHi;
+    }
+
+    return candidates[lo];
+}
+
+double BatchDecider::narrow(double lo, double hi, double tolerance, int lanes)
+{
+    lanes = std::max(1, lanes);
+    std::vector<double> eps(lanes);
+
+    for (int pass = 0; pass < 60 && hi - lo > tolerance * std::max(1.0, hi); ++pass) {
+        for (int k = 0; k < lanes; ++k)
+            eps[k] = lo + (hi - lo) * (k + 1) / (lanes + 1);
+
+        std::vector<char> accepted = decide(eps);
+
+        int first = lanes;
+        for (int k = 0; k < lanes; ++k) {
+            if (accepted[k]) {
+                first = k;
+                break;
+            }
+        }
+
+        double newLo = first > 0 ? eps[first - 1] : lo;
+        double newHi = first < lanes ? eps[first] : hi;
+        lo = newLo;
+        hi = newHi;
+    }
+
+    return hi;
+}
+
+} // namespace Frechet
@@ -0,0 +1,70 @@
+#pragma once
+#include "Polyline.h"
+#include "robust.h"
+#include <vector>
+
+namespace Frechet {
+
+// Decides d_F(P,Q) <= eps for K thresholds in one pass over the grid.
+// The quadratic of every cell edge is set up once and shared by all
+// lanes, only the square root differs per threshold. Per cell the K
+// discriminants and square roots are computed first in plain array loops
+// the compiler can vectorise; a second pass certifies the edge ends and
+// builds the intervals. Reachability is propagated row by row with the K
+// lanes stored side by side, so a pass needs O(K n) memory.
+class BatchDecider {
+public:
+    BatchDecider(const Polyline& P, const Polyline& Q);
+
+    // one result per threshold, same order
+    std::vector<char> decide(const std::vector<double>& eps);
+
+    // smallest accepted value of a sorted candidate list by K-ary search;
+    // the last candidate must be accepted
+    double smallestAccepted(const std::vector<double>& candidates, int lanes = DefaultLanes);
+
+    // bisection over [lo, hi] with K probes per pass until the relative
+    // width is below tolerance; returns the accepted end
+    double narrow(double lo, double hi, double tolerance, int lanes = DefaultLanes);
+
+    inline int passes() const { return passes_; }
+
+    static constexpr int DefaultLanes = 8;
+
+private:
+    const Polyline& P_;
+    const Polyline& Q_;
+    int passes_ = 0;
+
+    // |A + s(B-A) - C|^2 = a s^2 + b s + c0, and c1 at s = 1
+    struct Edge {
+        double a;
+        double b;
+        double c0;
+        double c1;
+    };
+
+    static Edge edge(const Point& A, const Point& B, const Point& C);
+    // free interval of an edge at eps, empty is lo > hi; the points are
+    // only read when an end test needs the exact fallback
+    static void freeInterval(const Edge& edge, const Point& A, const Point& B, const Point& C,
+                             const DistanceFilter& filter, double& lo, double& hi);
+    // the same with the discriminant and its square root precomputed
+    static void freeInterval(const Edge& edge, const Point& A, const Point& B, const Point& C,
+                             const DistanceFilter& filter, double disc, double root,
+                             double& lo, double& hi);
+    // discriminants and square roots of an edge for all lanes
+    void roots(const Edge& edge, double* disc, double* root) const;
+
+    // lane-local buffers, reused across passes
+    std::vector<DistanceFilter> filters_;
+    std::vector<double> e2_;                  // eps^2 per lane
+    std::vector<double> topDisc_, topRoot_;     // per lane, current cell
+    std::vector<double> rightDisc_, rightRoot_;
+    std::vector<Edge> firstColumn_; // Q segment j vs P[0]
+    std::vector<double> leftLo_, leftHi_;     // reachable left side per (j, lane)
+    std::vector<double> bottomLo_, bottomHi_; // reachable bottom per lane
+    std::vector<double> chainLo_, chainHi_;   // bottom row chain per lane
+};
+
+} // namespace Frechet
@@ -0,0 +1,206 @@
+#include "bounds.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Frechet {
+
+double pointDistance(const Point& a, const Point& b)
+{
+    return std::hypot(a.x() - b.x(), a.y() - b.y());
+}
+
+double pointSegmentDistance(const Point& p, const Point& a, const Point& b)
+{
+    Point d = b - a;
+    double len2 = d.x() * d.x() + d.y() * d.y();
+    if (len2 < 1e-24)
+        return pointDistance(p, a);
+
+    double s = ((p.x() - a.x()) * d.x() + (p.y() - a.y()) * d.y()) / len2;
+    s = std::clamp(s, 0.0, 1.0);
+    return pointDistance(p, a + s * d);
+}
+
+double endpointLowerBound(const Polyline& P, const Polyline& Q)
+{
+    if (P.vertices.empty() || Q.vertices.empty())
+        return 0.0;
+
+    return std::max(pointDistance(P.vertices.front(), Q.vertices.front()),
+                    pointDistance(P.vertices.back(), Q.vertices.back()));
+}
+
+double greedyUpperBound(const Polyline& P, const Polyline& Q)
+{
+    int n = P.size();
+    int m = Q.size();
+    if (n == 0 || m == 0)
+        return 0.0;
+
+    int i = 0;
+    int j = 0;
+    double bound = pointDistance(P.vertices[0], Q.vertices[0]);
+
+    // every step (advance P, advance Q or both) is a linear motion,
+    // so the leash is longest at one of the coupled vertex pairs
+    while (i < n - 1 || j < m - 1) {
+        double best = 1e300;
+        int bi = i, bj = j;
+
+        auto consider = [&](int ni, int nj) {
+            if (ni >= n || nj >= m) return;
+            double d = pointDistance(P.vertices[ni], Q.vertices[nj]);
+            if (d < best) {
+                best = d;
+                bi = ni;
+                bj = nj;
+            }
+        };
+
+        consider(i + 1, j + 1);
+        consider(i + 1, j);
+        consider(i, j + 1);
+
+        i = bi;
+        j = bj;
+        bound = std::max(bound, best);
+    }
+
+    return bound;
+}
+
+bool hausdorffWithin(const Polyline& from, const Polyline& to, double eps)
+{
+    BoundsScratch scratch;
+    return hausdorffWithin(from, to, eps, scratch);
+}
+
+bool hausdorffWithin(const Polyline& from, const Polyline& to, double eps, BoundsScratch& scratch)
+{
+    if (from.vertices.empty() || to.vertices.empty())
+        return true;
+
+    double minX = 1e300, minY = 1e300, maxX = -1e300, maxY = -1e300;
+    for (const auto& q : to.vertices) {
+        minX = std::min(minX, q.x());
+        minY = std::min(minY, q.y());
+        maxX = std::max(maxX, q.x());
+        maxY = std::max(maxY, q.y());
+    }
+
+    // cell is never smaller than eps, so a 5x5 neighbourhood covers the eps-disc
+    // (segments are sampled every half cell); the extent cap keeps sampling bounded
+    double diag = std::hypot(maxX - minX, maxY - minY);
+    double cell = std::max({eps, diag / 256.0, 1e-9});
+
+    auto cellOf = [&](double v, double origin) {
+        return static_cast<long long>(std::floor((v - origin) / cell));
+    };
+    auto key = [](long long cx, long long cy) {
+        return static_cast<long long>((static_cast<unsigned long long>(cx) << 32)
+                                      ^ (static_cast<unsigned long long>(cy) & 0xffffffffULL));
+    };
+
+    // sorted (cell, segment) pairs instead of a hash map, so the buffer is reusable
+    auto& grid = scratch.grid;
+    grid.clear();
+    int segments = std::max(1, to.size() - 1);
+
+    for (int k = 0; k < segments; ++k) {
+        const Point& a = to.vertices[k];
+        const Point& b = to.vertices[std::min(k + 1, to.size() - 1)];
+
+        int steps = static_cast<int>(std::ceil(pointDistance(a, b) / (0.5 * cell)));
+        long long lastKey = 0;
+        bool hasLast = false;
+
+        for (int s = 0; s <= steps; ++s) {
+            double t = steps == 0 ? 0.0 : static_cast<double>(s) / steps;
+            Point p = a + t * (b - a);
+            long long k2 = key(cellOf(p.x(), minX), cellOf(p.y(), minY));
+            if (hasLast && k2 == lastKey)
+                continue;
+
+            grid.emplace_back(k2, k);
+            lastKey = k2;
+            hasLast = true;
+        }
+    }
+
+    std::sort(grid.begin(), grid.end());
+    grid.erase(std::unique(grid.begin(), grid.end()), grid.end());
+
+    for (const auto& p : from.vertices) {
+        long long cx = cellOf(p.x(), minX);
+        long long cy = cellOf(p.y(), minY);
+        bool found = false;
+
+        for (long long dx = -2; dx <= 2 && !found; ++dx) {
+            for (long long dy = -2; dy <= 2 && !found; ++dy) {
+                long long k2 = key(cx + dx, cy + dy);
+                auto it = std::lower_bound(grid.begin(), grid.end(), std::make_pair(k2, -1));
+
+                for (; it != grid.end() && it->first == k2; ++it) {
+                    int k = it->second;
+                    const Point& a = to.vertices[k];
+                    const Point& b = to.vertices[std::min(k + 1, to.size() - 1)];
+                    if (pointSegmentDistance(p, a, b) <= eps) {
+                        found = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (!found)
+            return false;
+    }
+
+    return true;
+}
+
+bool discreteFrechetWithin(const Polyline& P, const Polyline& Q, double eps)
+{
+    BoundsScratch scratch;
+    return discreteFrechetWithin(P, Q, eps, scratch);
+}
+
+bool discreteFrechetWithin(const Polyline& P, const Polyline& Q, double eps, BoundsScratch& scratch)
+{
+    int n = P.size();
+    int m = Q.size();
+    if (n == 0 || m == 0)
+        return false;
+
+    // two rows side by side in one buffer
+    scratch.rows.assign(2 * m, 0);
+    char* prev = scratch.rows.data();
+    char* cur = prev + m;
+
+    for (int i = 0; i < n; ++i) {
+        bool any = false;
+        for (int j = 0; j < m; ++j) {
+            bool close = pointDistance(P.vertices[i], Q.vertices[j]) <= eps;
+            bool from;
+            if (i == 0 && j == 0)
+                from = true;
+            else
+                from = (i > 0 && prev[j])
+                    || (j > 0 && cur[j-1])
+                    || (i > 0 && j > 0 && prev[j-1]);
+
+            cur[j] = close && from;
+            any = any || cur[j];
+        }
+
+        // no coupling survives this row
+        if (!any)
+            return false;
+
+        std::swap(prev, cur);
+    }
+
+    return prev[m-1];
+}
+
+} // namespace Frechet
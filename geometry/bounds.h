@@ -0,0 +1,30 @@
+#pragma once
+#include "Polyline.h"
+#include <utility>
+
+namespace Frechet {
+
+double pointDistance(const Point& a, const Point& b);
+double pointSegmentDistance(const Point& p, const Point& a, const Point& b);
+
+// Lower bound: both curves must start and end together
+double endpointLowerBound(const Polyline& P, const Polyline& Q);
+
+// Upper bound: max leash length of a greedy monotone walk over vertex pairs
+double greedyUpperBound(const Polyline& P, const Polyline& Q);
+
+// Scratch buffers, reused so repeated bound evaluations do not allocate
+struct BoundsScratch {
+    std::vector<std::pair<long long, int>> grid;  // (cell key, segment), sorted
+    std::vector<char> rows;
+};
+
+// Is every vertex of `from` within eps of `to`? (directed Hausdorff, grid-accelerated)
+bool hausdorffWithin(const Polyline& from, const Polyline& to, double eps);
+bool hausdorffWithin(const Polyline& from, const Polyline& to, double eps, BoundsScratch& scratch);
+
+// Discrete Frechet decision over vertex couplings, O(m) memory
+bool discreteFrechetWithin(const Polyline& P, const Polyline& Q, double eps);
+bool discreteFrechetWithin(const Polyline& P, const Polyline& Q, double eps, BoundsScratch& scratch);
+
+} // namespace Frechet
@@ -0,0 +1,114 @@
+#include "closedfrechet.h"
+#include "epstimeline.h"
+#include "reachability.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Frechet {
+
+static Polyline closed(const Polyline& c)
+{
+    Polyline result = c;
+    if (!result.vertices.empty() && result.vertices.front() != result.vertices.back())
+        result.vertices.push_back(result.vertices.front());
+    return result;
+}
+
+ClosedFrechet::ClosedFrechet(const Polyline& P, const Polyline& Q)
+    : P_(closed(P))
+    , Q_(closed(Q))
+{
+    n_ = std::max(P_.size() - 1, 0);
+
+    Polyline doubled = P_;
+    for (int k = 1; k < P_.size(); ++k)
+        doubled.vertices.push_back(P_.vertices[k]);
+
+    doubled_ = std::make_unique<FreeSpace>(doubled, Q_, 0.0);
+}
+
+ClosedFrechet::Result ClosedFrechet::decide(double eps)
+{
+    if (n_ < 1 || Q_.size() < 2)
+        return {false, 0.0};
+
+    doubled_->setEps(eps);
+    Reachability reach(*doubled_, Reachability::Mode::Subtrajectory);
+    reach.compute();
+
+    // a shift s works if the path starting at s on the bottom edge ends
+    // at s + n on the top edge. An end e of a match is reached exactly
+    // from the starts() between earliestStart and max(start, min(e,
+    // latestStart)); with s = e - n <= e that is s <= latestStart
+    const auto& starts = reach.starts();
+    for (const auto& match : reach.matches()) {
+        double lo = std::max({match.earliestStart, match.endStart - n_, 0.0});
+        double hi = std::min({match.latestStart, match.endEnd - n_, double(n_)});
+        if (lo > hi)
+            continue;
+
+        // first start interval ending at or after lo
+        auto it = std::lower_bound(starts.begin(), starts.end(), lo,
+                                   [](const Interval& I, double value) { return I.end < value; });
+        if (it == starts.end() || it->start > hi)
+            continue;
+
+        // shift n is shift 0 on the second copy of P
+        double shift = std::max(lo, it->start);
+        return {true, shift < n_ ? shift : 0.0};
+    }
+
+    return {false, 0.0};
+}
+
+double ClosedFrechet::distance(double tolerance)
+{
+    if (n_ < 1 || Q_.size() < 2)
+        return 0.0;
+
+    // shift 0 is one of the shifts, its distance bounds the minimum
+    double lo = 0.0;
+    double hi = EpsTimeline(P_, Q_).criticalEps();
+    bestShift_ = 0.0;
+
+    while (hi - lo > tolerance * std::max(1.0, hi)) {
+        double mid = 0.5 * (lo + hi);
+        Result r = decide(mid);
+        if (r.found) {
+            hi = mid;
+            bestShift_ = r.shift;
+        } else {
+            lo = mid;
+        }
+    }
+
+    shiftedP_ = rotate(bestShift_);
+    FreeSpace fs(shiftedP_, Q_, hi * (1.0 + 1e-9));
+    fs.computeReachability();
+    matching_ = fs.computeCriticalPath();
+
+    return hi;
+}
+
+Polyline ClosedFrechet::rotate(double shift) const
+{
+    int k = static_cast<int>(std::floor(shift));
+    double alpha = shift - k;
+    const auto& v = P_.vertices;
+
+    Point start = (1.0 - alpha) * v[k] + alpha * v[k + 1];
+
+    Polyline result;
+    result.vertices.push_back(start);
+    for (int i = 1; i <= n_; ++i) {
+        const Point& p = v[(k + i) % n_];
+        if (i == 1 && p == start)
+            continue;
+        result.vertices.push_back(p);
+    }
+    if (result.vertices.back() != start)
+        result.vertices.push_back(start);
+    return result;
+}
+
+} // namespace Frechet
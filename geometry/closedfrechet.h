@@ -0,0 +1,50 @@
+#pragma once
+#include "freespace.h"
+#include <memory>
+
+namespace Frechet {
+
+// Frechet distance between closed curves, minimised over the starting
+// point of P. The free space is built once over P concatenated with
+// itself; a shift s works if the start s on its bottom edge reaches the
+// end s + n on its top edge, which a single subtrajectory sweep answers
+// for every s at once from its exact start ranges.
+class ClosedFrechet {
+public:
+    // Curves are closed by repeating the first vertex if necessary
+    ClosedFrechet(const Polyline& P, const Polyline& Q);
+
+    struct Result {
+        bool found;
+        double shift; // P parameter at which P starts, in [0, n)
+    };
+
+    // Is some cyclic shift of P within eps of Q?
+    Result decide(double eps);
+
+    // Bisects decide() down to the given tolerance and extracts the
+    // matching of the best shift
+    double distance(double tolerance = 1e-6);
+
+    inline double bestShift() const { return bestShift_; }
+
+    // P rotated to start at bestShift(), and the critical path of that
+    // rotation against Q (free-space coordinates of the rotated curve)
+    inline const Polyline& shiftedP() const { return shiftedP_; }
+    inline const std::vector<QPointF>& matching() const { return matching_; }
+
+private:
+    Polyline P_;
+    Polyline Q_;
+    int n_;
+
+    std::unique_ptr<FreeSpace> doubled_; // P∘P × Q, 2n x m cells
+
+    double bestShift_ = 0.0;
+    Polyline shiftedP_;
+    std::vector<QPointF> matching_;
+
+    Polyline rotate(double shift) const;
+};
+
+} // namespace Frechet
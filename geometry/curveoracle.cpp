@@ -0,0 +1,185 @@
+#include "curveoracle.h"
+#include "batchdecider.h"
+#include "bounds.h"
+#include "decider.h"
+#include "simplification.h"
+#include <algorithm>
+
+namespace Frechet {
+
+// hierarchy depth cap, levels normally stop at the extent of P
+static const int MaxLevels = 48;
+
+LongCurveOracle::LongCurveOracle(const Polyline& P)
+    : LongCurveOracle(P, Options())
+{
+}
+
+LongCurveOracle::LongCurveOracle(const Polyline& P, Options options)
+    : P_(P)
+    , options_(options)
+{
+    options_.leafSize = std::max(2, options_.leafSize);
+
+    double minX = 1e300, minY = 1e300, maxX = -1e300, maxY = -1e300;
+    for (const auto& p : P_.vertices) {
+        minX = std::min(minX, p.x());
+        minY = std::min(minY, p.y());
+        maxX = std::max(maxX, p.x());
+        maxY = std::max(maxY, p.y());
+    }
+    double diag = P_.vertices.empty() ? 0.0 : std::hypot(maxX - minX, maxY - minY);
+
+    base_ = options_.baseError > 0.0 ? options_.baseError : std::max(1e-4 * diag, 1e-12);
+
+    if (P_.size() >= 2) {
+        // any subcurve is within its extent of the segment between its
+        // endpoints, so levels beyond the diagonal add nothing
+        levels_ = 1;
+        while (levels_ < MaxLevels && levelError(levels_) < diag)
+            ++levels_;
+
+        nodes_.reserve(2 * P_.size() / options_.leafSize + 2);
+        build(0, P_.size() - 1);
+    }
+}
+
+int LongCurveOracle::build(int lo, int hi)
+{
+    int index = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();
+    nodes_.back().lo = lo;
+    nodes_.back().hi = hi;
+
+    if (hi - lo > options_.leafSize) {
+        int mid = lo + (hi - lo) / 2;
+        int left = build(lo, mid);
+        int right = build(mid, hi);
+        nodes_[index].left = left;
+        nodes_[index].right = right;
+    }
+
+    // level l from level l - 1 (the raw subcurve for l = 1) with the
+    // extra error delta_l - delta_{l-1}; internal nodes start from their
+    // children's level l - 1, so errors add up to exactly delta_l
+    Node& node = nodes_[index];
+    node.simplified.reserve(levels_);
+    for (int l = 1; l <= levels_; ++l) {
+        Polyline source;
+        if (node.left < 0) {
+            if (l == 1)
+                source.vertices.assign(P_.vertices.begin() + lo, P_.vertices.begin() + hi + 1);
+            else
+                source = node.simplified[l - 2];
+        } else {
+            collect(nodes_[index].left, lo, hi, l - 1, source);
+            collect(nodes_[index].right, lo, hi, l - 1, source);
+        }
+
+        node.simplified.push_back(simplifyFrechet(source, levelError(l) - levelError(l - 1)));
+    }
+
+    return index;
+}
+
+void LongCurveOracle::append(Polyline& out, const Polyline& piece)
+{
+    // consecutive pieces share their boundary vertex
+    auto begin = piece.vertices.begin();
+    if (!out.vertices.empty() && begin != piece.vertices.end())
+        ++begin;
+    out.vertices.insert(out.vertices.end(), begin, piece.vertices.end());
+}
+
+void LongCurveOracle::collect(int index, int first, int last, int level, Polyline& out) const
+{
+    const Node& node = nodes_[index];
+    if (node.hi < first || node.lo > last || (node.hi == first && node.lo < first))
+        return;
+
+    if (first <= node.lo && node.hi <= last) {
+        if (level == 0) {
+            Polyline raw;
+            raw.vertices.assign(P_.vertices.begin() + node.lo, P_.vertices.begin() + node.hi + 1);
+            append(out, raw);
+        } else {
+            append(out, node.simplified[level - 1]);
+        }
+        return;
+    }
+
+    if (node.left < 0) {
+        // partially covered leaf: raw vertices
+        Polyline raw;
+        raw.vertices.assign(P_.vertices.begin() + std::max(node.lo, first),
+                            P_.vertices.begin() + std::min(node.hi, last) + 1);
+        append(out, raw);
+        return;
+    }
+
+    collect(node.left, first, last, level, out);
+    collect(node.right, first, last, level, out);
+}
+
+Polyline LongCurveOracle::approximate(int first, int last, double maxError, double* error) const
+{
+    if (last < 0 || last >= P_.size())
+        last = P_.size() - 1;
+    first = std::clamp(first, 0, std::max(last, 0));
+
+    int level = 0;
+    while (level < levels_ && levelError(level + 1) <= maxError)
+        ++level;
+
+    Polyline result;
+    if (nodes_.empty() || first == last) {
+        if (!P_.vertices.empty())
+            result.vertices.push_back(P_.vertices[first]);
+    } else {
+        collect(0, first, last, level, result);
+    }
+
+    if (error)
+        *error = levelError(level);
+    return result;
+}
+
+LongCurveOracle::Estimate LongCurveOracle::distance(const Polyline& Q, double relativeError,
+                                                    int first, int last) const
+{
+    Estimate estimate{0.0, 0.0};
+    if (P_.size() == 0 || Q.size() == 0)
+        return estimate;
+
+    for (int level = levels_; level >= 0; --level) {
+        double error;
+        Polyline S = approximate(first, last, levelError(level), &error);
+
+        Decider decider(Q, S);
+        BatchDecider batch(Q, S);
+        double lo = decider.lowerBound();
+        double hi = decider.upperBound();
+        double d = hi > lo ? batch.narrow(lo, hi, 1e-6) : hi;
+
+        estimate = {d, error};
+        if (error <= relativeError * std::max(d - error, 0.0) || level == 0)
+            break;
+
+        // skip levels that are still too coarse for this distance
+        while (level > 1 && levelError(level - 1) > relativeError * d)
+            --level;
+    }
+
+    return estimate;
+}
+
+bool LongCurveOracle::decide(const Polyline& Q, double eps, double relativeError, int first, int last) const
+{
+    Polyline S = approximate(first, last, relativeError * eps);
+
+    Decider decider(Q, S);
+    decider.setCacheEnabled(false);
+    return decider.decide(eps).withinEps;
+}
+
+} // namespace Frechet
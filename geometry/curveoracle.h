@@ -0,0 +1,63 @@
+#pragma once
+#include "Polyline.h"
+#include <cmath>
+#include <vector>
+
+namespace Frechet {
+
+// Preprocessed long reference curve P for many short queries Q.
+// A segment tree over the vertices of P stores, per node, a hierarchy of
+// Frechet simplifications of its subcurve with errors base * 2^(l-1).
+// A query over P[first..last] concatenates the simplifications of the
+// O(log n) canonical nodes at the coarsest level the accuracy allows,
+// so its cost depends on the complexity of P at the scale of the answer
+// rather than on |P|.
+class LongCurveOracle {
+public:
+    struct Options {
+        double baseError = 0.0; // error of level 1, 0: 1e-4 of P's extent
+        int leafSize = 16;      // vertices per leaf
+    };
+
+    // true distance lies in [distance - error, distance + error]
+    struct Estimate {
+        double distance;
+        double error;
+    };
+
+    explicit LongCurveOracle(const Polyline& P);
+    LongCurveOracle(const Polyline& P, Options options);
+
+    // curve within Frechet distance *error of P[first..last], at the
+    // coarsest level with error <= maxError (last = -1: end of P)
+    Polyline approximate(int first, int last, double maxError, double* error = nullptr) const;
+
+    // coarse to fine until error <= relativeError * distance
+    Estimate distance(const Polyline& Q, double relativeError = 0.1, int first = 0, int last = -1) const;
+
+    // approximate decision: true when d_F(Q, P[first..last]) <= (1 - relativeError) eps,
+    // false when it is above (1 + relativeError) eps, either in between
+    bool decide(const Polyline& Q, double eps, double relativeError = 0.1, int first = 0, int last = -1) const;
+
+    inline int levels() const { return levels_; }
+    inline double levelError(int level) const { return level == 0 ? 0.0 : base_ * std::ldexp(1.0, level - 1); }
+
+private:
+    struct Node {
+        int lo, hi;          // vertex range, inclusive; siblings share their boundary vertex
+        int left = -1, right = -1;
+        std::vector<Polyline> simplified; // level l at index l - 1
+    };
+
+    const Polyline& P_;
+    Options options_;
+    double base_;
+    int levels_ = 0;
+    std::vector<Node> nodes_;
+
+    int build(int lo, int hi);
+    void collect(int node, int first, int last, int level, Polyline& out) const;
+    static void append(Polyline& out, const Polyline& piece);
+};
+
+} // namespace Frechet
@@ -0,0 +1,62 @@
+#include "decider.h"
+#include "bounds.h"
+#include "freespace.h"
+#include "resultcache.h"
+#include "workspace.h"
+
+namespace Frechet {
+
+Decider::Decider(const Polyline& P, const Polyline& Q, Workspace* workspace)
+    : P_(P), Q_(Q), workspace_(workspace)
+{
+    endpointBound_ = endpointLowerBound(P_, Q_);
+    greedyBound_ = greedyUpperBound(P_, Q_);
+}
+
+Decider::Result Decider::decide(double eps) const {
+    if (endpointBound_ > eps)
+        return {false, Stage::Endpoints};
+
+    if (greedyBound_ <= eps)
+        return {true, Stage::GreedyWalk};
+
+    auto& cache = ResultCache::instance();
+    if (cacheEnabled_ && cacheKey_.isEmpty())
+        cacheKey_ = ResultCache::key(P_, Q_);
+
+    bool cached;
+    if (cacheEnabled_ && cache.findDecision(cacheKey_, eps, cached))
+        return {cached, Stage::Cache};
+
+    Workspace local;
+    Workspace& ws = workspace_ ? *workspace_ : local;
+
+    bool hausdorff = hausdorffWithin(P_, Q_, eps, ws.boundsScratch())
+                  && hausdorffWithin(Q_, P_, eps, ws.boundsScratch());
+
+    // a single point is matched to everything, so Hausdorff is exact there
+    if (!hausdorff || P_.size() < 2 || Q_.size() < 2)
+        return {hausdorff, Stage::Hausdorff};
+
+    if (discreteFrechetWithin(P_, Q_, eps, ws.boundsScratch()))
+        return {true, Stage::DiscreteMatching};
+
+    bool within = ws.decide(P_, Q_, eps);
+    if (cacheEnabled_)
+        cache.storeDecision(cacheKey_, eps, within);
+    return {within, Stage::FreeSpace};
+}
+
+QString Decider::stageName(Stage stage) {
+    switch (stage) {
+    case Stage::Endpoints:        return "endpoints";
+    case Stage::GreedyWalk:       return "greedy walk";
+    case Stage::Hausdorff:        return "hausdorff";
+    case Stage::Cache:            return "cache";
+    case Stage::DiscreteMatching: return "discrete matching";
+    case Stage::FreeSpace:        return "free space";
+    }
+    return QString();
+}
+
+} // namespace Frechet
@@ -0,0 +1,56 @@
+#pragma once
+#include "Polyline.h"
+#include <QByteArray>
+#include <QString>
+
+namespace Frechet {
+
+class Workspace;
+
+// Answers "is d_F(P,Q) <= eps?" by trying cheap bounds before
+// falling back to the full FreeSpace + Reachability computation.
+class Decider {
+public:
+    enum class Stage {
+        Endpoints,        // lower bound: endpoint distances
+        GreedyWalk,       // upper bound: greedy vertex walk
+        Hausdorff,        // lower bound: directed Hausdorff (grid)
+        Cache,            // exact: earlier result for the same pair
+        DiscreteMatching, // upper bound: discrete Frechet matching
+        FreeSpace         // exact: free space diagram
+    };
+
+    struct Result {
+        bool withinEps;
+        Stage stage;  // which filter decided the query
+    };
+
+    // with a workspace, the bounds and the free space reuse its buffers
+    Decider(const Polyline& P, const Polyline& Q, Workspace* workspace = nullptr);
+
+    Result decide(double eps) const;
+
+    // transient pairs (e.g. one of many trial translations) should not
+    // fill the persistent result cache
+    inline void setCacheEnabled(bool enabled) { cacheEnabled_ = enabled; }
+
+    inline double lowerBound() const { return endpointBound_; }
+    inline double upperBound() const { return greedyBound_; }
+
+    static QString stageName(Stage stage);
+
+private:
+    const Polyline& P_;
+    const Polyline& Q_;
+    Workspace* workspace_;
+
+    // eps-independent bounds, computed once per pair
+    double endpointBound_;
+    double greedyBound_;
+
+    // content hash for the result cache, computed on first use
+    bool cacheEnabled_ = true;
+    mutable QByteArray cacheKey_;
+};
+
+} // namespace Frechet
@@ -0,0 +1,121 @@
+#include "epsscrubber.h"
+#include <algorithm>
+
+namespace Frechet {
+
+EpsScrubber::EpsScrubber(FreeSpace& fs, int first, int last, qint64 maxBytes)
+    : fs_(&fs), first_(first), last_(std::max(first, last))
+{
+    auto& cells = fs_->getCells();
+    int m = fs_->getM();
+    int n = fs_->getN();
+    double positions = last_ - first_ + 1.0;
+    if (positions * m * n > MaxSweepCells)
+        return;
+
+    size_t maxChanges = static_cast<size_t>(std::max<qint64>(maxBytes, 0)) / sizeof(Change);
+    std::vector<Bound> state(static_cast<size_t>(m) * n * IntervalsPerCell, Bound{1.0, 0.0});
+
+    for (int value = first_; value <= last_; ++value) {
+        fs_->setEps(value);
+        fs_->computeReachability();
+
+        // the first position is the base state, only later ones are deltas
+        size_t before = changes_.size();
+        bool base = value == first_;
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < n; ++j) {
+                quint32 cell = static_cast<quint32>(i * n + j);
+                for (int f = 0; f < IntervalsPerCell; ++f) {
+                    const Interval& e = field(cells[i][j], f);
+                    Bound b = e.isEmpty() ? Bound{1.0, 0.0} : Bound{e.start, e.end};
+                    Bound& s = state[cell * IntervalsPerCell + f];
+                    if (b.start == s.start && b.end == s.end)
+                        continue;
+                    if (!base)
+                        changes_.push_back({cell * IntervalsPerCell + f, s, b});
+                    s = b;
+                }
+            }
+        }
+
+        if (changes_.size() > maxChanges) {
+            changes_ = std::vector<Change>();
+            values_.clear();
+            offsets_.clear();
+            return;
+        }
+        if (changes_.size() > before || base) {
+            values_.push_back(value);
+            offsets_.push_back(before);
+        }
+    }
+    offsets_.push_back(changes_.size());
+
+    current_ = static_cast<int>(values_.size()) - 1;
+    valid_ = true;
+}
+
+void EpsScrubber::attach(FreeSpace& fs)
+{
+    fs_ = &fs;
+    current_ = -1;
+}
+
+Interval& EpsScrubber::field(FrechetCell& cell, int f)
+{
+    static Interval FrechetCell::* const fields[IntervalsPerCell] = {
+        &FrechetCell::bottom, &FrechetCell::top, &FrechetCell::left, &FrechetCell::right,
+        &FrechetCell::reachableBottom, &FrechetCell::reachableTop,
+        &FrechetCell::reachableLeft, &FrechetCell::reachableRight};
+    return cell.*fields[f];
+}
+
+void EpsScrubber::apply(const Change& change, bool forward)
+{
+    int n = fs_->getN();
+    int cell = static_cast<int>(change.interval / IntervalsPerCell);
+    FrechetCell& c = fs_->getCells()[cell / n][cell % n];
+
+    const Bound& b = forward ? change.after : change.before;
+    field(c, change.interval % IntervalsPerCell) = Interval(b.start, b.end);
+
+    // the predecessors follow from the incoming reachable intervals
+    auto pred = [&]() {
+        if (!c.reachableLeft.isEmpty())
+            return FrechetCell::PredOrigin::Left;
+        if (!c.reachableBottom.isEmpty())
+            return FrechetCell::PredOrigin::Bottom;
+        return FrechetCell::PredOrigin::None;
+    };
+    c.predTop = c.predRight = pred();
+}
+
+void EpsScrubber::seek(int value)
+{
+    if (!valid_)
+        return;
+
+    value = std::clamp(value, first_, last_);
+    int target = static_cast<int>(std::upper_bound(values_.begin(), values_.end(), value) - values_.begin()) - 1;
+
+    // nothing changes between values_[target] and value, so recomputing
+    // at value gives exactly the stored state
+    if (current_ < 0) {
+        fs_->setEps(value);
+        fs_->computeReachability();
+        current_ = target;
+        return;
+    }
+
+    for (; current_ < target; ++current_)
+        for (size_t k = offsets_[current_ + 1]; k < offsets_[current_ + 2]; ++k)
+            apply(changes_[k], true);
+    for (; current_ > target; --current_)
+        for (size_t k = offsets_[current_ + 1]; k-- > offsets_[current_];)
+            apply(changes_[k], false);
+
+    fs_->setEpsState(value);
+}
+
+} // namespace Frechet
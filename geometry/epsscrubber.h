@@ -0,0 +1,62 @@
+#pragma once
+#include "freespace.h"
+#include <QtGlobal>
+#include <vector>
+
+namespace Frechet {
+
+// Free space states of one pair at every integer slider position, kept as
+// deltas: a position records only the free and reachable intervals that
+// differ from the previous one, with their values before and after.
+// Positions that change nothing are not stored, so seeking finds the
+// target by binary search over the rest and applies only the deltas in
+// between, forwards or backwards, to the FreeSpace in place.
+class EpsScrubber {
+public:
+    // Sweeps fs through eps = first..last once. The states are dropped
+    // (isValid() false, fs left at some eps) if the sweep is too long or
+    // the deltas outgrow maxBytes
+    EpsScrubber(FreeSpace& fs, int first, int last, qint64 maxBytes);
+
+    inline bool isValid() const { return valid_; }
+
+    // moves the scrubber onto fs, a FreeSpace of the same pair, e.g. when
+    // the sweep ran on a private copy in the background; the next seek
+    // recomputes fs once, later ones apply the deltas
+    void attach(FreeSpace& fs);
+
+    // brings fs to eps = value, clamped to the range
+    void seek(int value);
+
+    // cells times positions swept at most
+    static constexpr double MaxSweepCells = 5e7;
+
+private:
+    struct Bound {
+        double start; // empty is {1, 0}
+        double end;
+    };
+
+    struct Change {
+        quint32 interval; // cell * IntervalsPerCell + field
+        Bound before;
+        Bound after;
+    };
+
+    static constexpr int IntervalsPerCell = 8;
+
+    FreeSpace* fs_;
+    int first_;
+    int last_;
+    bool valid_ = false;
+
+    std::vector<int> values_;     // positions that change something, ascending
+    std::vector<size_t> offsets_; // values_[k] changes [offsets_[k], offsets_[k + 1])
+    std::vector<Change> changes_;
+    int current_ = 0;             // fs holds the state of values_[current_], -1 unknown
+
+    static Interval& field(FrechetCell& cell, int f);
+    void apply(const Change& change, bool forward);
+};
+
+} // namespace Frechet
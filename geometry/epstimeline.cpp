@@ -0,0 +1,147 @@
+#include "epstimeline.h"
+#include "bounds.h"
+#include "batchdecider.h"
+#include "decider.h"
+#include "resultcache.h"
+#include <algorithm>
+
+namespace Frechet {
+
+EpsTimeline::EpsTimeline(const Polyline& P, const Polyline& Q)
+    : P_(P), Q_(Q)
+{
+    if (P.size() == 0 || Q.size() == 0)
+        return;
+
+    // a repeated pair needs neither the events nor a decision
+    auto& cache = ResultCache::instance();
+    ResultCache::Key key = ResultCache::key(P, Q);
+    if (cache.findDistance(key, criticalEps_))
+        return;
+
+    ensureEvents();
+
+    // the distance is the smallest event the decider accepts; events
+    // outside [lower, upper] cannot be critical and were not collected
+    std::vector<double> candidates;
+    for (const auto& e : events_)
+        if (e.eps >= lower_ && e.eps <= upper_)
+            candidates.push_back(e.eps);
+    candidates.push_back(upper_);
+
+    // K thresholds per pass over the grid instead of one decision per step
+    BatchDecider batch(P, Q);
+    criticalEps_ = batch.smallestAccepted(candidates);
+
+    bool monotonicity = 2.0 * P.size() * Q.size() * (P.size() + Q.size()) <= MonotonicityBudget;
+    if (!monotonicity) {
+        // between two consecutive events the answer may still flip at a
+        // monotonicity event we did not collect, narrow that gap. The
+        // result is the accepted end of a bisection, an upper bound only:
+        // cached as a distance it would turn down every eps just below it
+        auto below = std::lower_bound(candidates.begin(), candidates.end(), criticalEps_);
+        double a = below != candidates.begin() ? *(below - 1) : lower_;
+        criticalEps_ = batch.narrow(a, criticalEps_, 1e-9);
+        cache.storeDecision(key, criticalEps_, true);
+        return;
+    }
+
+    cache.storeDistance(key, criticalEps_);
+}
+
+const std::vector<EpsTimeline::Event>& EpsTimeline::events() const
+{
+    ensureEvents();
+    return events_;
+}
+
+void EpsTimeline::ensureEvents() const
+{
+    if (collected_ || P_.size() == 0 || Q_.size() == 0)
+        return;
+    collected_ = true;
+
+    Decider decider(P_, Q_);
+    lower_ = decider.lowerBound();
+    upper_ = decider.upperBound();
+    collectEvents(P_, Q_, lower_, upper_);
+}
+
+void EpsTimeline::collectEvents(const Polyline& P, const Polyline& Q, double lower, double upper) const
+{
+    events_.push_back({lower, EventType::Endpoints});
+
+    // vertex of one curve against a segment of the other
+    auto vertexEdge = [&](const Polyline& A, const Polyline& B) {
+        for (const auto& a : A.vertices)
+            for (int k = 0; k + 1 < B.size(); ++k)
+                events_.push_back({pointSegmentDistance(a, B.vertices[k], B.vertices[k + 1]),
+                                   EventType::VertexEdge});
+    };
+    vertexEdge(P, Q);
+    vertexEdge(Q, P);
+
+    if (2.0 * P.size() * Q.size() * (P.size() + Q.size()) <= MonotonicityBudget) {
+        addMonotonicityEvents(P, Q, lower, upper);
+        addMonotonicityEvents(Q, P, lower, upper);
+    }
+
+    std::sort(events_.begin(), events_.end(),
+              [](const Event& a, const Event& b) { return a.eps < b.eps; });
+}
+
+void EpsTimeline::addMonotonicityEvents(const Polyline& A, const Polyline& B, double lower, double upper) const
+{
+    // points on a segment of B equidistant to two vertices of A
+    for (int k = 0; k < A.size(); ++k) {
+        for (int l = k + 1; l < A.size(); ++l) {
+            const Point& ak = A.vertices[k];
+            const Point& al = A.vertices[l];
+            Point w = al - ak;
+            double c = 0.5 * (QPointF::dotProduct(al, al) - QPointF::dotProduct(ak, ak));
+
+            for (int s = 0; s + 1 < B.size(); ++s) {
+                const Point& b0 = B.vertices[s];
+                Point d = B.vertices[s + 1] - b0;
+                double denom = QPointF::dotProduct(d, w);
+                if (std::abs(denom) < 1e-12)
+                    continue;
+
+                double t = (c - QPointF::dotProduct(b0, w)) / denom;
+                if (t < 0.0 || t > 1.0)
+                    continue;
+
+                double eps = pointDistance(b0 + t * d, ak);
+                if (eps >= lower && eps <= upper)
+                    events_.push_back({eps, EventType::Monotonicity});
+            }
+        }
+    }
+}
+
+int EpsTimeline::eventIndex(double eps) const
+{
+    ensureEvents();
+    auto it = std::upper_bound(events_.begin(), events_.end(), eps,
+                               [](double v, const Event& e) { return v < e.eps; });
+    return static_cast<int>(it - events_.begin());
+}
+
+double EpsTimeline::snap(double eps) const
+{
+    ensureEvents();
+    if (events_.empty())
+        return eps;
+
+    int k = eventIndex(eps);
+    if (k == 0)
+        return events_.front().eps;
+    if (k == static_cast<int>(events_.size()))
+        return events_.back().eps;
+
+    double below = events_[k - 1].eps;
+    double above = events_[k].eps;
+    return eps - below <= above - eps ? below : above;
+}
+
+} // namespace Frechet
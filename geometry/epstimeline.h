@@ -0,0 +1,58 @@
+#pragma once
+#include "Polyline.h"
+#include <vector>
+
+namespace Frechet {
+
+// One-time sweep over all critical eps values of a pair of curves.
+// Free space and reachability only change combinatorially at these
+// events, so "is the diagram reachable at eps" is answered by binary
+// search instead of rebuilding the free space.
+class EpsTimeline {
+public:
+    enum class EventType {
+        Endpoints,    // start or end points at distance eps
+        VertexEdge,   // a free interval appears on a cell edge
+        Monotonicity  // two free intervals in a row/column line up
+    };
+
+    struct Event {
+        double eps;
+        EventType type;
+    };
+
+    EpsTimeline(const Polyline& P, const Polyline& Q);
+
+    // sorted by eps; collected on first use when the distance came from
+    // the result cache
+    const std::vector<Event>& events() const;
+
+    // exact Frechet distance (smallest reachable event)
+    inline double criticalEps() const { return criticalEps_; }
+    inline bool isReachable(double eps) const { return eps >= criticalEps_; }
+
+    // number of events at or below eps, O(log E)
+    int eventIndex(double eps) const;
+
+    // event closest to eps
+    double snap(double eps) const;
+
+    // monotonicity events cost O(m^2 n + m n^2), above this only the
+    // bisection fallback is used for them
+    static constexpr double MonotonicityBudget = 4e6;
+
+private:
+    Polyline P_;
+    Polyline Q_;
+    mutable std::vector<Event> events_;
+    mutable bool collected_ = false;
+    mutable double lower_ = 0.0;
+    mutable double upper_ = 0.0;
+    double criticalEps_ = 0.0;
+
+    void ensureEvents() const;
+    void collectEvents(const Polyline& P, const Polyline& Q, double lower, double upper) const;
+    void addMonotonicityEvents(const Polyline& A, const Polyline& B, double lower, double upper) const;
+};
+
+} // namespace Frechet
@@ -1,8 +1,10 @@
 #include "freespace.h"
+#include "localmatching.h"
 #include "reachability.h"
-#include "reachability.h"
+#include "robust.h"
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 using std::max;
 using std::min;
@@ -16,87 +18,164 @@ static double dot(const Point& a, const Point& b)
    Solve inequality:
    || (1-s)A + sB - C ||^2 <= eps^2
    for s in [0,1]
+
+   The ends s = 0 and s = 1 decide whether neighbouring cells connect,
+   so their membership comes in certified (see robust.h); only the
+   interior roots carry plain rounding error.
 */
-static Interval segmentPointInterval(
+Interval segmentPointInterval(
     const Point& A,
     const Point& B,
     const Point& C,
     double eps)
 {
+    Frechet::DistanceFilter filter(eps);
     Point d = B - A;
     Point f = A - C;
+    Point g = B - C;
 
     double a = dot(d, d);
     double b = 2.0 * dot(d, f);
-    double c = dot(f, f) - eps * eps;
-
-    // Segment is a point
-    if (std::abs(a) < 1e-12)
-    {
-        if (c <= 0.0)
-            return Interval(0.0, 1.0);
-        else
-            return Interval(1.0, 0.0);
-    }
+    double fa = dot(f, f);
 
-    double disc = b * b - 4 * a * c;
-    if (disc < 0.0)
-        return Interval(1.0, 0.0);
+    return Frechet::solveFreeInterval(a, b, fa - filter.e2,
+                                      filter.compare(fa, A, C) <= 0,
+                                      filter.compare(dot(g, g), B, C) <= 0);
+}
 
-    double sqrtDisc = std::sqrt(disc);
-    double s1 = (-b - sqrtDisc) / (2 * a);
-    double s2 = (-b + sqrtDisc) / (2 * a);
+FreeSpace::FreeSpace(const Polyline& P_,
+                     const Polyline& Q_,
+                     double epsilon)
+    : FreeSpace(makePolyline(P_), makePolyline(Q_), epsilon)
+{
+}
 
-    double start = max(0.0, min(s1, s2));
-    double end   = min(1.0, max(s1, s2));
+FreeSpace::FreeSpace(PolylinePtr P_,
+                     PolylinePtr Q_,
+                     double epsilon)
+    : P(std::move(P_)), Q(std::move(Q_)), eps(epsilon)
+{
+    int n = P->vertices.size() - 1;
+    int m = Q->vertices.size() - 1;
 
-    if (start > end)
-        return Interval(1.0, 0.0);
+    cells.resize(std::max(n, 0), std::vector<FrechetCell>(std::max(m, 0)));
+    computeCells();
+}
 
-    return Interval(start, end);
+void FreeSpace::reset(const Polyline& P_,
+                      const Polyline& Q_,
+                      double epsilon)
+{
+    // vector copy-assignment keeps the existing capacity
+    assignPolyline(P, P_);
+    assignPolyline(Q, Q_);
+    eps = epsilon;
+    resetCells();
 }
 
-FreeSpace::FreeSpace(const Polyline& P_,
-                     const Polyline& Q_,
-                     double epsilon)
-    : P(P_), Q(Q_), eps(epsilon)
+void FreeSpace::reset(PolylinePtr P_,
+                      PolylinePtr Q_,
+                      double epsilon)
 {
-    int n = P.vertices.size() - 1;
-    int m = Q.vertices.size() - 1;
+    P = std::move(P_);
+    Q = std::move(Q_);
+    eps = epsilon;
+    resetCells();
+}
+
+void FreeSpace::resetCells()
+{
+    int n = std::max(static_cast<int>(P->vertices.size()) - 1, 0);
+    int m = std::max(static_cast<int>(Q->vertices.size()) - 1, 0);
+
+    while (static_cast<int>(cells.size()) > n) {
+        spareRows.push_back(std::move(cells.back()));
+        cells.pop_back();
+    }
+    while (static_cast<int>(cells.size()) < n) {
+        if (spareRows.empty()) {
+            cells.emplace_back();
+        } else {
+            cells.push_back(std::move(spareRows.back()));
+            spareRows.pop_back();
+        }
+    }
+
+    // assign() clears stale reachability without giving up capacity
+    for (auto& row : cells)
+        row.assign(m, FrechetCell());
+
+    criticalPath.clear();
+    pathComputed = false;
+    criticalEps = -1;
+    matching.clear();
+    matchingComputed = false;
 
-    cells.resize(n, std::vector<FrechetCell>(m));
     computeCells();
 }
 
 void FreeSpace::computeCells()
 {
-    int n = P.vertices.size() - 1;
-    int m = Q.vertices.size() - 1;
+    int n = P->vertices.size() - 1;
+    int m = Q->vertices.size() - 1;
 
     for (int i = 0; i < n; ++i)
-    {
         for (int j = 0; j < m; ++j)
-        {
-            const Point& p0 = P.vertices[i];
-            const Point& p1 = P.vertices[i + 1];
-            const Point& q0 = Q.vertices[j];
-            const Point& q1 = Q.vertices[j + 1];
+            computeCell(i, j);
 
-            FrechetCell& cell = cells[i][j];
-
-            // bottom: P(s) vs Q[j]
-            cell.bottom = segmentPointInterval(p0, p1, q0, eps);
-
-            // top: P(s) vs Q[j+1]
-            cell.top = segmentPointInterval(p0, p1, q1, eps);
-
-            // left: Q(t) vs P[i]
-            cell.left = segmentPointInterval(q0, q1, p0, eps);
+    reachabilityComputed = false;
+}
 
-            // right: Q(t) vs P[i+1]
-            cell.right = segmentPointInterval(q0, q1, p1, eps);
-        }
+void FreeSpace::computeCell(int i, int j)
+{
+    const Point& p0 = P->vertices[i];
+    const Point& p1 = P->vertices[i + 1];
+    const Point& q0 = Q->vertices[j];
+    const Point& q1 = Q->vertices[j + 1];
+
+    FrechetCell& cell = cells[i][j];
+
+    // most cells of a long pair lie far off the diagonal: once the bounding
+    // boxes of the two segments are more than eps apart (with slack for the
+    // rounded gap) no corner or edge comes close
+    double gapX = max(min(p0.x(), p1.x()) - max(q0.x(), q1.x()),
+                      min(q0.x(), q1.x()) - max(p0.x(), p1.x()));
+    double gapY = max(min(p0.y(), p1.y()) - max(q0.y(), q1.y()),
+                      min(q0.y(), q1.y()) - max(p0.y(), p1.y()));
+    if (max(gapX, gapY) > eps * (1.0 + 4.0 * std::numeric_limits<double>::epsilon())) {
+        cell.bottom = cell.top = cell.left = cell.right = Interval();
+        return;
     }
+
+    // segmentPointInterval per edge, with the four corners shared: every
+    // corner belongs to two edges (Q-side edges see the corner offsets
+    // negated, which is exact). The corner signs go first, so little is
+    // live across their rare extended-precision fallback
+    Frechet::DistanceFilter filter(eps);
+    double d00 = dot(p0 - q0, p0 - q0);
+    double d10 = dot(p1 - q0, p1 - q0);
+    double d01 = dot(p0 - q1, p0 - q1);
+    bool free00 = filter.compare(d00, p0, q0) <= 0;
+    bool free10 = filter.compare(d10, p1, q0) <= 0;
+    bool free01 = filter.compare(d01, p0, q1) <= 0;
+    bool free11 = filter.compare(p1, q1) <= 0;
+
+    Point dp = p1 - p0;
+    Point dq = q1 - q0;
+    double ap = dot(dp, dp);
+    double aq = dot(dq, dq);
+
+    // bottom: P(s) vs Q[j]
+    cell.bottom = Frechet::solveFreeInterval(ap, 2.0 * dot(dp, p0 - q0), d00 - filter.e2, free00, free10);
+
+    // top: P(s) vs Q[j+1]
+    cell.top = Frechet::solveFreeInterval(ap, 2.0 * dot(dp, p0 - q1), d01 - filter.e2, free01, free11);
+
+    // left: Q(t) vs P[i]
+    cell.left = Frechet::solveFreeInterval(aq, -2.0 * dot(dq, p0 - q0), d00 - filter.e2, free00, free01);
+
+    // right: Q(t) vs P[i+1]
+    cell.right = Frechet::solveFreeInterval(aq, -2.0 * dot(dq, p1 - q0), d10 - filter.e2, free10, free11);
 }
 
 void FreeSpace::setEps(double e) {
@@ -107,8 +186,58 @@ void FreeSpace::setEps(double e) {
 void FreeSpace::computeReachability() {
     Frechet::Reachability reach(*this);
     reach.compute();
+    reachabilityComputed = true;
 }
 
+void FreeSpace::appendToP(const Point& p)
+{
+    detach(P).vertices.push_back(p);
+    int m = Q->vertices.size() - 1;
+    if (P->vertices.size() < 2 || m < 1)
+        return;
+
+    int i = P->vertices.size() - 2;
+    cells.emplace_back(m);
+    for (int j = 0; j < m; ++j)
+        computeCell(i, j);
+
+    pathComputed = false;
+    criticalPath.clear();
+    matchingComputed = false;
+
+    if (reachabilityComputed || i == 0) {
+        Frechet::Reachability reach(*this);
+        reach.extendP();
+        reachabilityComputed = true;
+    }
+}
+
+void FreeSpace::appendToQ(const Point& q)
+{
+    detach(Q).vertices.push_back(q);
+    int n = P->vertices.size() - 1;
+    if (Q->vertices.size() < 2 || n < 1)
+        return;
+
+    int j = Q->vertices.size() - 2;
+    // rows appended to P while Q was a single vertex are still missing
+    if (j == 0)
+        cells.resize(n);
+    for (int i = 0; i < n; ++i) {
+        cells[i].emplace_back();
+        computeCell(i, j);
+    }
+
+    pathComputed = false;
+    criticalPath.clear();
+    matchingComputed = false;
+
+    if (reachabilityComputed || j == 0) {
+        Frechet::Reachability reach(*this);
+        reach.extendQ();
+        reachabilityComputed = true;
+    }
+}
 
 bool FreeSpace::isTopRightReachable() const {
     int m = getM();
@@ -127,75 +256,20 @@ bool FreeSpace::isTopRightReachable() const {
 
 std::vector<QPointF> FreeSpace::computeCriticalPath() {
     std::vector<QPointF> path;
+    computeCriticalPath(path);
+    return path;
+}
 
-    int m = getM();
-    int n = getN();
-    auto& cells = getCells();
-
-    if (m == 0 || n == 0) return path;
-
-    // --- start in upper right corner ---
-    int i = m - 1;
-    int j = n - 1;
-    FrechetCell* cell = &cells[i][j];
-
-    bool onTop = !cell->reachableTop.isEmpty();
-    bool onRight = !cell->reachableRight.isEmpty();
-    if (!onTop && !onRight) return path;
-
-    while (i >= 0 && j >= 0) {
-        if (onTop) {
-            double mid = 0.5 * (cell->reachableTop.start + cell->reachableTop.end);
-            double x = i + mid;
-            double y = j + 1; // top edge
-            path.push_back(QPointF(x, y));
-
-            if (cell->predTop == FrechetCell::PredOrigin::Left) {
-                --i;
-                if (i < 0) break;
-                cell = &cells[i][j];
-                onTop = false;
-                onRight = true;
-            } else if (cell->predTop == FrechetCell::PredOrigin::Bottom) {
-                --j;
-                if (j < 0) break;
-                cell = &cells[i][j];
-                onTop = true;
-                onRight = false;
-            } else {
-                break; // None
-            }
-        } else if (onRight) {
-            double mid = 0.5 * (cell->reachableRight.start + cell->reachableRight.end);
-            double x = i + 1; // right edge
-            double y = j + mid;
-            path.push_back(QPointF(x, y));
-
-            if (cell->predRight == FrechetCell::PredOrigin::Bottom) {
-                --j;
-                if (j < 0) break;
-                cell = &cells[i][j];
-                onTop = true;
-                onRight = false;
-            } else if (cell->predRight == FrechetCell::PredOrigin::Left) {
-                --i;
-                if (i < 0) break;
-                cell = &cells[i][j];
-                onTop = false;
-                onRight = true;
-            } else {
-                break; // None
-            }
-        } else {
-            break;
-        }
-    }
+void FreeSpace::computeCriticalPath(std::vector<QPointF>& path) {
+    path.clear();
 
-    if (path.empty() || path.front() != QPointF(0.0, 0.0))
-        path.push_back(QPointF(0.0, 0.0));
+    if (!isTopRightReachable()) return;
 
-    std::reverse(path.begin(), path.end());
-    path.pop_back();
-    path.push_back(QPointF(m, n));
-    return path;
+    // the locally correct matching never exceeds d_F <= eps, so it runs
+    // through this diagram as well, and once computed serves every eps
+    if (!matchingComputed) {
+        Frechet::LocalMatching(*P, *Q, this).compute(matching);
+        matchingComputed = true;
+    }
+    path = matching;
 }
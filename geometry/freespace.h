@@ -4,11 +4,23 @@
 #include <vector>
 #include <QLineF>
 
+// Free part of segment AB against point C: { s in [0,1] : |A + s(B-A) - C| <= eps }
+Interval segmentPointInterval(const Point& A, const Point& B, const Point& C, double eps);
+
 class FreeSpace {
 public:
     FreeSpace(const Polyline& P, const Polyline& Q, double epsilon);
+    FreeSpace(PolylinePtr P, PolylinePtr Q, double epsilon); // shares the curves
+
+    // Reuse this object for another pair: buffers only ever grow,
+    // rows of a smaller pair are parked instead of freed
+    void reset(const Polyline& P, const Polyline& Q, double epsilon);
+    void reset(PolylinePtr P, PolylinePtr Q, double epsilon);
+
+    inline const PolylinePtr& getP() const {return P;}
+    inline const PolylinePtr& getQ() const {return Q;}
     inline int getM() const {return cells.size();}
-    inline int getN() const {return cells[0].size();}
+    inline int getN() const {return cells.empty() ? 0 : cells[0].size();}
     inline double getEps() const {return eps;}
 
     const std::vector<std::vector<FrechetCell>>& getCells() const {
@@ -22,8 +34,16 @@ public:
     void computeCells();
 
     void setEps(double e);
+    // eps of cells and reachability already brought to that state from
+    // outside (Frechet::EpsScrubber), nothing is recomputed
+    inline void setEpsState(double e) { eps = e; reachabilityComputed = true; }
     void computeReachability();
 
+    // Online mode: add a vertex, compute only the new row (P) or column (Q)
+    // of cells and extend the reachability from the stored boundary
+    void appendToP(const Point& p);
+    void appendToQ(const Point& q);
+
     std::vector<QPointF> criticalPath;
     bool pathComputed = false;
     int criticalEps = -1;
@@ -31,12 +51,22 @@ public:
 
     bool isTopRightReachable() const;
     std::vector<QPointF> computeCriticalPath();
+    void computeCriticalPath(std::vector<QPointF>& path);
 private:
-    Polyline P;
-    Polyline Q;
+    PolylinePtr P;
+    PolylinePtr Q;
     double eps;
 
     std::vector<std::vector<FrechetCell>> cells;
+    std::vector<std::vector<FrechetCell>> spareRows;
+    bool reachabilityComputed = false;
+
+    // the locally correct matching of the pair, independent of eps
+    std::vector<QPointF> matching;
+    bool matchingComputed = false;
+
+    void computeCell(int i, int j);
+    void resetCells();
 
     Interval computeBottomInterval(const Point& p0, const Point& p1, const Point& q0);
     Interval computeTopInterval(const Point& p0, const Point& p1, const Point& q1);
@@ -0,0 +1,187 @@
+#include "kcenter.h"
+#include "bounds.h"
+#include "decider.h"
+#include "epstimeline.h"
+#include "workspace.h"
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Frechet {
+
+static double exactDistance(const Polyline& A, const Polyline& B)
+{
+    return EpsTimeline(A, B).criticalEps();
+}
+
+KCenterClustering::KCenterClustering(const std::vector<Polyline>& curves, Options options)
+    : curves_(curves)
+    , options_(options)
+{
+}
+
+const Polyline& KCenterClustering::centerCurve(int center)
+{
+    auto it = centerCurves_.find(center);
+    if (it == centerCurves_.end()) {
+        Polyline c = options_.centerVertices > 1
+            ? simplify(curves_[center], options_.centerVertices)
+            : curves_[center];
+        it = centerCurves_.emplace(center, std::move(c)).first;
+    }
+    return it->second;
+}
+
+double KCenterClustering::distance(int curve, int center)
+{
+    auto it = memo_.find(key(curve, center));
+    if (it != memo_.end())
+        return it->second;
+
+    double d = exactDistance(curves_[curve], centerCurve(center));
+    memo_.emplace(key(curve, center), d);
+    return d;
+}
+
+KCenterClustering::Result KCenterClustering::run()
+{
+    Result result;
+    int n = static_cast<int>(curves_.size());
+    if (n == 0)
+        return result;
+
+    int k = std::clamp(options_.k, 1, n);
+    bool simplified = options_.centerVertices > 1;
+
+    result.assignment.assign(n, 0);
+    result.distance.assign(n, std::numeric_limits<double>::infinity());
+
+    std::vector<int> indices(n);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::vector<char> isCenter(n, 0);
+    std::vector<double> computed(n);
+    std::vector<char> hasComputed(n);
+    std::atomic<int> decisions{0};
+    std::atomic<int> evaluations{0};
+
+    int next = 0;
+    for (int slot = 0; slot < k; ++slot) {
+        result.centers.push_back(next);
+        isCenter[next] = 1;
+
+        const Polyline& center = centerCurve(next);
+        std::fill(hasComputed.begin(), hasComputed.end(), 0);
+
+        // the memo is only read here, new distances are merged afterwards
+        auto update = [&](int i) {
+            double current = result.distance[i];
+            if (i == next && !simplified) {
+                computed[i] = 0.0;
+                hasComputed[i] = 1;
+                return;
+            }
+
+            auto it = memo_.find(key(i, next));
+            if (it != memo_.end()) {
+                computed[i] = it->second;
+                hasComputed[i] = 1;
+                return;
+            }
+
+            // only curves closer to the new center need the exact distance
+            // per-radius decisions of the search, keep them out of the result cache
+            if (std::isfinite(current)) {
+                thread_local Workspace workspace;
+                ++decisions;
+                Decider decider(curves_[i], center, &workspace);
+                decider.setCacheEnabled(false);
+                if (!decider.decide(current).withinEps)
+                    return;
+            }
+
+            ++evaluations;
+            computed[i] = exactDistance(curves_[i], center);
+            hasComputed[i] = 1;
+        };
+        QtConcurrent::blockingMap(indices, update);
+
+        for (int i = 0; i < n; ++i) {
+            if (!hasComputed[i])
+                continue;
+            memo_.emplace(key(i, next), computed[i]);
+            if (computed[i] < result.distance[i]) {
+                result.distance[i] = computed[i];
+                result.assignment[i] = slot;
+            }
+        }
+
+        // farthest curve that is not a center yet
+        double farthest = -1.0;
+        for (int i = 0; i < n; ++i) {
+            if (!isCenter[i] && result.distance[i] > farthest) {
+                farthest = result.distance[i];
+                next = i;
+            }
+        }
+        if (farthest <= 0.0)
+            break;
+    }
+
+    for (int c : result.centers)
+        result.centerCurves.push_back(centerCurve(c));
+
+    result.radii.assign(result.centers.size(), 0.0);
+    for (int i = 0; i < n; ++i) {
+        int slot = result.assignment[i];
+        result.radii[slot] = std::max(result.radii[slot], result.distance[i]);
+    }
+    result.radius = *std::max_element(result.radii.begin(), result.radii.end());
+    result.decisions = decisions;
+    result.distanceEvaluations = evaluations;
+    return result;
+}
+
+Polyline KCenterClustering::simplify(const Polyline& curve, int l)
+{
+    int n = curve.size();
+    if (n <= l || l < 2)
+        return curve;
+
+    // Douglas-Peucker order: repeatedly keep the vertex farthest from
+    // the current simplification until l vertices are kept
+    std::vector<char> keep(n, 0);
+    keep[0] = keep[n - 1] = 1;
+
+    for (int kept = 2; kept < l; ++kept) {
+        double best = -1.0;
+        int bestIndex = -1;
+        int a = 0;
+        for (int b = 1; b < n; ++b) {
+            if (!keep[b])
+                continue;
+            for (int v = a + 1; v < b; ++v) {
+                double d = pointSegmentDistance(curve.vertices[v], curve.vertices[a], curve.vertices[b]);
+                if (d > best) {
+                    best = d;
+                    bestIndex = v;
+                }
+            }
+            a = b;
+        }
+        if (bestIndex < 0)
+            break;
+        keep[bestIndex] = 1;
+    }
+
+    Polyline result;
+    for (int v = 0; v < n; ++v)
+        if (keep[v])
+            result.vertices.push_back(curve.vertices[v]);
+    return result;
+}
+
+} // namespace Frechet
@@ -0,0 +1,56 @@
+#pragma once
+#include "Polyline.h"
+#include <unordered_map>
+#include <vector>
+
+namespace Frechet {
+
+// Gonzalez k-center clustering of a curve set under the Frechet distance.
+// Each new center is the curve farthest from the current ones; a curve
+// only needs its exact distance to the new center when the decider says
+// it is closer than its current center, so the run costs O(nk) decisions
+// and usually far fewer exact distances.
+class KCenterClustering {
+public:
+    struct Options {
+        int k = 3;
+        int centerVertices = 0; // l > 1: (k,l)-center with simplified centers
+    };
+
+    struct Result {
+        std::vector<int> centers;          // indices into the input set
+        std::vector<Polyline> centerCurves; // simplified if centerVertices > 1
+        std::vector<int> assignment;       // cluster of each curve
+        std::vector<double> distance;      // distance of each curve to its center
+        std::vector<double> radii;         // per cluster
+        double radius = 0.0;
+        int decisions = 0;
+        int distanceEvaluations = 0;
+    };
+
+    KCenterClustering(const std::vector<Polyline>& curves, Options options);
+
+    Result run();
+
+    // exact Frechet distance from a curve to the center built from curve
+    // `center`, memoized: a rerun with a larger k reuses earlier results
+    double distance(int curve, int center);
+
+    // vertex-restricted simplification to at most l vertices
+    static Polyline simplify(const Polyline& curve, int l);
+
+private:
+    const std::vector<Polyline>& curves_;
+    Options options_;
+
+    std::unordered_map<int, Polyline> centerCurves_; // by input index
+    std::unordered_map<long long, double> memo_;
+
+    const Polyline& centerCurve(int center);
+
+    inline long long key(int curve, int center) const {
+        return static_cast<long long>(center) * static_cast<long long>(curves_.size()) + curve;
+    }
+};
+
+} // namespace Frechet
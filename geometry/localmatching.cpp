@@ -0,0 +1,535 @@
+#include "localmatching.h"
+#include "bounds.h"
+#include "freespace.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Frechet {
+
+namespace {
+
+// Point at parameter t of a curve with at least one segment
+Point pointAt(const std::vector<Point>& v, double t)
+{
+    int k = std::clamp(static_cast<int>(std::floor(t)), 0, static_cast<int>(v.size()) - 2);
+    double s = t - k;
+    return (1.0 - s) * v[k] + s * v[k + 1];
+}
+
+// Parameter of the point of segment AB closest to C
+double projection(const Point& C, const Point& A, const Point& B)
+{
+    Point d = B - A;
+    double len2 = d.x() * d.x() + d.y() * d.y();
+    if (len2 < 1e-24)
+        return 0.0;
+    return std::clamp(((C.x() - A.x()) * d.x() + (C.y() - A.y()) * d.y()) / len2, 0.0, 1.0);
+}
+
+} // namespace
+
+LocalMatching::LocalMatching(const Polyline& P, const Polyline& Q, const FreeSpace* diagram)
+    : P_(P), Q_(Q), diagram_(diagram), m_(P.size() - 1), n_(Q.size() - 1)
+{
+}
+
+LocalMatching::Nearest LocalMatching::nearest(const Point& c, const std::vector<Point>& curve,
+                                              double lo, double hi)
+{
+    Point A = pointAt(curve, lo);
+    Point B = pointAt(curve, hi);
+    double s = projection(c, A, B);
+    return {pointDistance(c, A + s * (B - A)), lo + s * (hi - lo)};
+}
+
+std::vector<QPointF> LocalMatching::compute()
+{
+    std::vector<QPointF> path;
+    compute(path);
+    return path;
+}
+
+void LocalMatching::compute(std::vector<QPointF>& path)
+{
+    path.clear();
+    if (m_ < 0 || n_ < 0)
+        return;
+
+    path.push_back(QPointF(0.0, 0.0));
+
+    // vertex against whole edge, the events of every piece away from its border
+    const auto& p = P_.vertices;
+    const auto& q = Q_.vertices;
+    nearV_.resize(static_cast<size_t>(m_ + 1) * std::max(n_, 0));
+    nearH_.resize(static_cast<size_t>(n_ + 1) * std::max(m_, 0));
+    for (int k = 0; k <= m_; ++k) {
+        for (int j = 0; j < n_; ++j)
+            nearV_[k * n_ + j] = nearest(p[k], q, j, j + 1);
+    }
+    for (int j = 0; j <= n_; ++j) {
+        for (int i = 0; i < m_; ++i)
+            nearH_[j * m_ + i] = nearest(q[j], p, i, i + 1);
+    }
+
+    // depth-first, first half on top, so end points arrive in path order;
+    // the diagram's eps bounds the whole matching
+    maxDepth_ = 3 * static_cast<int>(std::ceil(std::log2(m_ + n_ + 2.0)));
+    std::vector<Piece> stack;
+    stack.push_back({0.0, 0.0, static_cast<double>(m_), static_cast<double>(n_),
+                     diagram_ ? diagram_->getEps() : std::numeric_limits<double>::infinity(), 0});
+
+    while (!stack.empty()) {
+        Piece piece = stack.back();
+        stack.pop_back();
+
+        QPointF at;
+        double eps;
+        if (m_ > 0 && n_ > 0) {
+            setPiece(piece);
+            bool cut = split(at, eps);
+            if (cut && piece.depth < maxDepth_) {
+                // rounding in the event point must not step back
+                at = QPointF(std::clamp(at.x(), piece.x0, piece.x1),
+                             std::clamp(at.y(), piece.y0, piece.y1));
+                stack.push_back({at.x(), at.y(), piece.x1, piece.y1, eps, piece.depth + 1});
+                stack.push_back({piece.x0, piece.y0, at.x(), at.y(), eps, piece.depth + 1});
+                continue;
+            }
+
+            // too deep or no event: follow the piece's own reachability,
+            // at its distance if split() got that far, else at the parent's
+            bool several = (cols_ > 1 || rows_ > 1) && piece.x1 > piece.x0 && piece.y1 > piece.y0;
+            if (several && (reached_ || (std::isfinite(piece.eps) && forward(piece.eps * (1.0 + 1e-9))))) {
+                walk(path);
+                continue;
+            }
+        }
+
+        path.push_back(QPointF(piece.x1, piece.y1));
+    }
+}
+
+void LocalMatching::setPiece(const Piece& piece)
+{
+    piece_ = piece;
+    cx0_ = static_cast<int>(std::floor(piece.x0));
+    cy0_ = static_cast<int>(std::floor(piece.y0));
+    cols_ = std::max(1, static_cast<int>(std::ceil(piece.x1)) - cx0_);
+    rows_ = std::max(1, static_cast<int>(std::ceil(piece.y1)) - cy0_);
+
+    // a piece ending on the last vertex line still lies in the last cell
+    cx0_ = std::min(cx0_, m_ - 1);
+    cy0_ = std::min(cy0_, n_ - 1);
+
+    size_t v = static_cast<size_t>(cols_ + 1) * rows_;
+    size_t h = static_cast<size_t>(rows_ + 1) * cols_;
+    if (fwdV_.size() < v) {
+        fwdV_.resize(v);
+        bwdV_.resize(v);
+    }
+    if (fwdH_.size() < h) {
+        fwdH_.resize(h);
+        bwdH_.resize(h);
+    }
+}
+
+bool LocalMatching::split(QPointF& at, double& eps)
+{
+    const Piece& r = piece_;
+    reached_ = false;
+
+    // a point against a curve is matched in the only way possible,
+    // and within one cell the linear matching is locally correct
+    if (r.x1 <= r.x0 || r.y1 <= r.y0 || (cols_ < 2 && rows_ < 2))
+        return false;
+
+    const auto& p = P_.vertices;
+    const auto& q = Q_.vertices;
+
+    // vertex-edge events on the inner grid lines. Every matching crosses
+    // every inner line, so none is below the nearest event of any line
+    events_.clear();
+    int inner = cols_ * rows_;
+    double floor = 0.0;
+    for (int a = 1; a < cols_; ++a) {
+        double line = 1e300;
+        for (int edge = a * rows_; edge < (a + 1) * rows_; ++edge) {
+            events_.push_back({eventAt(edge).eps, edge});
+            line = std::min(line, events_.back().eps);
+        }
+        floor = std::max(floor, line);
+    }
+    for (int b = 1; b < rows_; ++b) {
+        double line = 1e300;
+        for (int edge = inner + b * cols_; edge < inner + (b + 1) * cols_; ++edge) {
+            events_.push_back({eventAt(edge).eps, edge});
+            line = std::min(line, events_.back().eps);
+        }
+        floor = std::max(floor, line);
+    }
+
+    // both pieces of curve fit in one box, whose diagonal bounds every
+    // distance between them; the parent's distance bounds the piece too
+    double minX = 1e300, minY = 1e300, maxX = -1e300, maxY = -1e300;
+    auto include = [&](const Point& v) {
+        minX = std::min(minX, v.x());
+        minY = std::min(minY, v.y());
+        maxX = std::max(maxX, v.x());
+        maxY = std::max(maxY, v.y());
+    };
+    include(pointAt(p, r.x0));
+    include(pointAt(p, r.x1));
+    for (int a = 1; a < cols_; ++a)
+        include(p[cx0_ + a]);
+    include(pointAt(q, r.y0));
+    include(pointAt(q, r.y1));
+    for (int b = 1; b < rows_; ++b)
+        include(q[cy0_ + b]);
+
+    double far = std::hypot(maxX - minX, maxY - minY);
+    if (far <= 0.0)
+        return false;
+    double ceiling = std::min(far, r.eps) * (1.0 + 1e-9);
+
+    // the weak distance of the piece, where its end cells first connect
+    // through cells sharing a free edge, bounds it from below and often
+    // is the answer; union-find over the events in order, where those
+    // below the floor need no order
+    int end = inner - 1;
+    parent_.resize(inner);
+    std::iota(parent_.begin(), parent_.end(), 0);
+    auto find = [&](int x) {
+        while (parent_[x] != x)
+            x = parent_[x] = parent_[parent_[x]];
+        return x;
+    };
+    auto unite = [&](int edge) {
+        int cell = edge < inner ? edge : (edge - inner) % cols_ * rows_ + (edge - inner) / cols_;
+        int before = edge < inner ? cell - rows_ : cell - 1;
+        parent_[find(before)] = find(cell);
+    };
+
+    double below = floor * (1.0 - 1e-9);
+    events_.erase(std::remove_if(events_.begin(), events_.end(), [&](const Event& e) {
+                      if (e.eps < below)
+                          unite(e.edge);
+                      return e.eps < below || e.eps > ceiling;
+                  }), events_.end());
+    std::sort(events_.begin(), events_.end(),
+              [](const Event& u, const Event& v) { return u.eps < v.eps; });
+
+    int count = static_cast<int>(events_.size());
+    int weak = 0;
+    while (weak < count && find(0) != find(end))
+        unite(events_[weak++].edge);
+
+    // smallest accepted event; a tangent event's free point only appears
+    // once rounding allows, so each is tried a hair above its value
+    const double hair = 1.0 + 1e-12;
+    int lo = -1;
+    int hi = count;
+    if (weak > 0) {
+        lo = weak - 2;
+        if (forward(events_[weak - 1].eps * hair))
+            hi = weak - 1;
+        else
+            lo = weak - 1;
+    }
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (forward(events_[mid].eps * hair))
+            hi = mid;
+        else
+            lo = mid;
+    }
+
+    // only a monotonicity event can open the piece in between
+    double upper = hi < count ? events_[hi].eps : ceiling;
+    double lower = lo >= 0 ? events_[lo].eps : 0.0;
+    double probe = upper - (upper - lower) * 1e-9;
+    if (probe > lower && forward(probe)) {
+        upper = probe;
+        while (upper - lower > 1e-10 * upper) {
+            double mid = 0.5 * (lower + upper);
+            if (forward(mid))
+                upper = mid;
+            else
+                lower = mid;
+        }
+    }
+    eps = upper;
+
+    // a hair above the distance, so the tangent event points are free
+    if (!forward(upper * hair + far * 1e-15) && !forward(ceiling))
+        return false;
+    reached_ = true;
+    backward();
+
+    // every matching of the piece passes the event point; among tied
+    // events (curves running together along a stretch tie everywhere)
+    // the one closest to the middle keeps the recursion shallow
+    auto balance = [&](const QPointF& z) {
+        return std::max(std::abs((z.x() - r.x0) / (r.x1 - r.x0) - 0.5),
+                        std::abs((z.y() - r.y0) / (r.y1 - r.y0) - 0.5));
+    };
+
+    // a tangent event decided right at its value may round either way,
+    // so the events within a hair of the distance all count as reached;
+    // only those whose point lies on some matching are passed by all
+    auto first = std::lower_bound(events_.begin(), events_.end(), upper * (1.0 - 1e-9),
+                                  [](const Event& u, double e) { return u.eps < e; });
+    bool tied = false;
+    for (auto it = first; it != events_.end() && it->eps <= upper * (1.0 + 1e-9); ++it) {
+        QPointF z = eventPoint(it->edge);
+        bool onMatching = it->edge < inner ? bwdV_[it->edge].contains(z.y())
+                                           : bwdH_[it->edge - inner].contains(z.x());
+        if (!onMatching)
+            continue;
+        if (!tied || balance(z) < balance(at))
+            at = z;
+        tied = true;
+    }
+    if (tied)
+        return true;
+
+    // a monotonicity event is a passage along a row or column. Each
+    // matching touches an inner grid line in one stretch, so the points
+    // every matching passes are those above the highest entry and below
+    // the lowest exit over all matchings (bwd holds the points that lie
+    // on some matching)
+    const double tie = 1e-6;
+    double bestGap = 1e300;
+    bool found = false;
+
+    auto consider = [&](double enter, double leave, double line, bool vertical) {
+        double mid = 0.5 * (enter + leave);
+        QPointF z = vertical ? QPointF(line, mid) : QPointF(mid, line);
+        double gap = enter - leave;
+        if (found && (gap > bestGap + tie || (gap > bestGap - tie && balance(z) >= balance(at))))
+            return;
+        bestGap = std::min(bestGap, gap);
+        at = z;
+        found = true;
+    };
+
+    for (int a = 1; a < cols_; ++a) {
+        double enter = -1e300;
+        double leave = 1e300;
+        for (int b = 0; b < rows_; ++b) {
+            const Interval& g = bwdV_[a * rows_ + b];
+            if (g.empty)
+                continue;
+
+            // leaving to the right: the cell there goes on to the end
+            bool right = a + 1 < cols_ && !bwdV_[(a + 1) * rows_ + b].empty
+                         && g.start <= bwdV_[(a + 1) * rows_ + b].end;
+            if ((a == cols_ - 1 && b == rows_ - 1) || right
+                || (b + 1 < rows_ && !bwdH_[(b + 1) * cols_ + a].empty))
+                leave = std::min(leave, g.start);
+
+            // entering from the left: the cell there is reached
+            bool left = a > 1 && !fwdV_[(a - 1) * rows_ + b].empty
+                        && fwdV_[(a - 1) * rows_ + b].start <= g.end;
+            if ((a == 1 && b == 0) || left || (b > 0 && !fwdH_[b * cols_ + a - 1].empty))
+                enter = std::max(enter, g.end);
+        }
+        if (enter > -1e300 && leave < 1e300)
+            consider(enter, leave, cx0_ + a, true);
+    }
+    for (int b = 1; b < rows_; ++b) {
+        double enter = -1e300;
+        double leave = 1e300;
+        for (int a = 0; a < cols_; ++a) {
+            const Interval& g = bwdH_[b * cols_ + a];
+            if (g.empty)
+                continue;
+
+            bool up = b + 1 < rows_ && !bwdH_[(b + 1) * cols_ + a].empty
+                      && g.start <= bwdH_[(b + 1) * cols_ + a].end;
+            if ((a == cols_ - 1 && b == rows_ - 1) || up
+                || (a + 1 < cols_ && !bwdV_[(a + 1) * rows_ + b].empty))
+                leave = std::min(leave, g.start);
+
+            bool below = b > 1 && !fwdH_[(b - 1) * cols_ + a].empty
+                         && fwdH_[(b - 1) * cols_ + a].start <= g.end;
+            if ((a == 0 && b == 1) || below || (a > 0 && !fwdV_[a * rows_ + b - 1].empty))
+                enter = std::max(enter, g.end);
+        }
+        if (enter > -1e300 && leave < 1e300)
+            consider(enter, leave, cy0_ + b, false);
+    }
+
+    return found;
+}
+
+// Vertex-edge event of an inner edge: vertical line a, row b is edge
+// a * rows + b, horizontal line b, column a is cols * rows + b * cols + a.
+// Only the first and last row/column are clipped by the piece
+LocalMatching::Nearest LocalMatching::eventAt(int edge) const
+{
+    const Piece& r = piece_;
+    int inner = cols_ * rows_;
+    if (edge < inner) {
+        int k = cx0_ + edge / rows_;
+        int j = cy0_ + edge % rows_;
+        double lo = std::max(r.y0, static_cast<double>(j));
+        double hi = std::min(r.y1, static_cast<double>(j + 1));
+        return lo == j && hi == j + 1 ? nearV_[k * n_ + j] : nearest(P_.vertices[k], Q_.vertices, lo, hi);
+    }
+    int j = cy0_ + (edge - inner) / cols_;
+    int i = cx0_ + (edge - inner) % cols_;
+    double lo = std::max(r.x0, static_cast<double>(i));
+    double hi = std::min(r.x1, static_cast<double>(i + 1));
+    return lo == i && hi == i + 1 ? nearH_[j * m_ + i] : nearest(Q_.vertices[j], P_.vertices, lo, hi);
+}
+
+QPointF LocalMatching::eventPoint(int edge) const
+{
+    int inner = cols_ * rows_;
+    if (edge < inner)
+        return QPointF(cx0_ + edge / rows_, eventAt(edge).at);
+    return QPointF(eventAt(edge).at, cy0_ + (edge - inner) / cols_);
+}
+
+// Free part of vertical inner line a in row b, clipped to the piece. An
+// edge the diagram does not reach is not reached at a smaller eps either
+Interval LocalMatching::freeV(int a, int b, double eps) const
+{
+    const auto& q = Q_.vertices;
+    int j = cy0_ + b;
+    if (diagram_ && eps <= diagram_->getEps() && diagram_->getCells()[cx0_ + a - 1][j].reachableRight.isEmpty())
+        return Interval();
+    Interval iv = segmentPointInterval(q[j], q[j + 1], P_.vertices[cx0_ + a], eps);
+    if (iv.empty)
+        return iv;
+    return Interval(std::max(j + iv.start, piece_.y0), std::min(j + iv.end, piece_.y1));
+}
+
+// Free part of horizontal inner line b in column a, clipped to the piece
+Interval LocalMatching::freeH(int b, int a, double eps) const
+{
+    const auto& p = P_.vertices;
+    int i = cx0_ + a;
+    if (diagram_ && eps <= diagram_->getEps() && diagram_->getCells()[i][cy0_ + b - 1].reachableTop.isEmpty())
+        return Interval();
+    Interval iv = segmentPointInterval(p[i], p[i + 1], Q_.vertices[cy0_ + b], eps);
+    if (iv.empty)
+        return iv;
+    return Interval(std::max(i + iv.start, piece_.x0), std::min(i + iv.end, piece_.x1));
+}
+
+bool LocalMatching::forward(double eps)
+{
+    // the start cell is open: its corner is the piece's start point, and
+    // the straight way from there to any free point of its top or right
+    // edge is no longer than the larger of the two end distances.
+    // Free intervals are only solved for edges of cells that are reached
+    for (int a = 0; a < cols_; ++a) {
+        bool through = false;
+        for (int b = 0; b < rows_; ++b) {
+            bool start = a == 0 && b == 0;
+            Interval left = a > 0 ? fwdV_[a * rows_ + b] : Interval();
+            Interval bottom = b > 0 ? fwdH_[b * cols_ + a] : Interval();
+            bool entered = start || !left.empty || !bottom.empty;
+
+            if (b + 1 < rows_) {
+                Interval top;
+                if (entered) {
+                    Interval f = freeH(b + 1, a, eps);
+                    if (start || !left.empty)
+                        top = f;
+                    else if (!f.empty)
+                        top = Interval(std::max(f.start, bottom.start), f.end);
+                }
+                fwdH_[(b + 1) * cols_ + a] = top;
+            }
+            if (a + 1 < cols_) {
+                Interval right;
+                if (entered) {
+                    Interval f = freeV(a + 1, b, eps);
+                    if (start || !bottom.empty)
+                        right = f;
+                    else if (!f.empty)
+                        right = Interval(std::max(f.start, left.start), f.end);
+                }
+                fwdV_[(a + 1) * rows_ + b] = right;
+                through = through || !right.empty;
+            }
+        }
+
+        // every matching crosses the next vertical line
+        if (a + 1 < cols_ && !through)
+            return false;
+    }
+
+    // the end cell is open likewise
+    int a = cols_ - 1;
+    int b = rows_ - 1;
+    return (a > 0 && !fwdV_[a * rows_ + b].empty) || (b > 0 && !fwdH_[b * cols_ + a].empty);
+}
+
+// Path from the piece's start to its end through the edges of the last
+// forward(), appended to path: back from the end, a point of a cell's top
+// or right edge is reached from any reached point of its left edge no
+// higher, or of its bottom edge no further right
+void LocalMatching::walk(std::vector<QPointF>& path) const
+{
+    size_t first = path.size();
+    QPointF c(piece_.x1, piece_.y1);
+    path.push_back(c);
+
+    int a = cols_ - 1;
+    int b = rows_ - 1;
+    while (a > 0 || b > 0) {
+        const Interval& left = fwdV_[a * rows_ + b];
+        const Interval& bottom = fwdH_[b * cols_ + a];
+        if (a > 0 && !left.empty && left.start <= c.y()) {
+            c = QPointF(cx0_ + a, std::min(c.y(), left.end));
+            --a;
+        } else if (b > 0 && !bottom.empty && bottom.start <= c.x()) {
+            c = QPointF(std::min(c.x(), bottom.end), cy0_ + b);
+            --b;
+        } else {
+            break;
+        }
+        path.push_back(c);
+    }
+
+    std::reverse(path.begin() + first, path.end());
+}
+
+// Points of the reached edges from which the end is reached as well,
+// i.e. the points of the inner lines that lie on some matching
+void LocalMatching::backward()
+{
+    for (int a = cols_ - 1; a >= 0; --a) {
+        for (int b = rows_ - 1; b >= 0; --b) {
+            bool end = a == cols_ - 1 && b == rows_ - 1;
+            Interval top = b + 1 < rows_ ? bwdH_[(b + 1) * cols_ + a] : Interval();
+            Interval right = a + 1 < cols_ ? bwdV_[(a + 1) * rows_ + b] : Interval();
+
+            if (a > 0) {
+                const Interval& f = fwdV_[a * rows_ + b];
+                Interval left;
+                if (end || !top.empty)
+                    left = f;
+                else if (!right.empty && !f.empty)
+                    left = Interval(f.start, std::min(f.end, right.end));
+                bwdV_[a * rows_ + b] = left;
+            }
+            if (b > 0) {
+                const Interval& f = fwdH_[b * cols_ + a];
+                Interval bottom;
+                if (end || !right.empty)
+                    bottom = f;
+                else if (!top.empty && !f.empty)
+                    bottom = Interval(f.start, std::min(f.end, top.end));
+                bwdH_[b * cols_ + a] = bottom;
+            }
+        }
+    }
+}
+
+} // namespace Frechet
@@ -0,0 +1,97 @@
+#pragma once
+#include "FrechetCell.h"
+#include "Polyline.h"
+#include <vector>
+#include <QPointF>
+
+class FreeSpace;
+
+namespace Frechet {
+
+// Locally correct Frechet matching (Buchin, Buchin, Meulemans, Speckmann):
+// every pair of subcurves matched to each other is matched at their own
+// Frechet distance, not only the pair of whole curves.
+//
+// The parameter rectangle is cut recursively at its bottleneck. The
+// distance of a piece is found by a decider over the piece's cells, with
+// the vertex-edge events as candidates and bisection for a monotonicity
+// event between two of them; every matching of the piece at that distance
+// passes the event, and the piece is split there. The end cells of a
+// piece stay open: its end points were fixed by the parent, so no
+// matching of the piece can do better near them. A piece inside a single
+// cell is matched linearly.
+//
+// Past a depth of a few times log2(m + n), or if no event can be found,
+// a piece is matched along the predecessor path of its reachability at
+// its own distance instead of being cut further, so the passes over all
+// pieces of one depth cost O(mn) each and their number stays logarithmic.
+//
+// One set of edge buffers serves every piece, sized to the largest. With
+// the diagram the matching is drawn in, edges it does not reach are not
+// solved: no piece reaches them at a smaller eps.
+class LocalMatching {
+public:
+    LocalMatching(const Polyline& P, const Polyline& Q, const FreeSpace* diagram = nullptr);
+
+    // Path through the free space from (0,0) to (m,n), P along x
+    std::vector<QPointF> compute();
+    void compute(std::vector<QPointF>& path);
+
+private:
+    struct Piece {
+        double x0, y0, x1, y1;
+        double eps; // distance of the parent, a bound for this piece
+        int depth;
+    };
+
+    struct Event {
+        double eps;
+        int edge; // see eventAt()
+    };
+
+    // distance to the closest point of a stretch of curve, and its parameter
+    struct Nearest {
+        double eps;
+        double at;
+    };
+
+    const Polyline& P_;
+    const Polyline& Q_;
+    const FreeSpace* diagram_;
+    int m_;
+    int n_;
+    int maxDepth_ = 0;
+
+    // current piece: cells [cx0, cx0 + cols) x [cy0, cy0 + rows)
+    Piece piece_;
+    int cx0_ = 0;
+    int cy0_ = 0;
+    int cols_ = 0;
+    int rows_ = 0;
+
+    // inner grid lines only, absolute coordinates, clipped to the piece;
+    // vertical line a, row b at [a * rows + b], horizontal line b, column a
+    // at [b * cols + a]
+    std::vector<Interval> fwdV_, fwdH_;
+    std::vector<Interval> bwdV_, bwdH_;
+    std::vector<Nearest> nearV_; // P[k] against Q segment j at [k * n + j]
+    std::vector<Nearest> nearH_; // Q[j] against P segment i at [j * m + i]
+    std::vector<Event> events_;
+    std::vector<int> parent_;
+    bool reached_ = false; // fwd holds a successful forward() of the piece
+
+    static Nearest nearest(const Point& c, const std::vector<Point>& curve, double lo, double hi);
+
+    void setPiece(const Piece& piece);
+    Nearest eventAt(int edge) const;
+    QPointF eventPoint(int edge) const;
+    bool split(QPointF& at, double& eps);
+
+    Interval freeV(int a, int b, double eps) const;
+    Interval freeH(int b, int a, double eps) const;
+    bool forward(double eps);
+    void backward();
+    void walk(std::vector<QPointF>& path) const;
+};
+
+} // namespace Frechet
@@ -0,0 +1,126 @@
+#include "lsh.h"
+#include "bounds.h"
+#include "decider.h"
+#include "workspace.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace Frechet {
+
+static std::uint64_t mix(std::uint64_t h, std::uint64_t v)
+{
+    // splitmix64 finaliser over the running hash
+    h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+FrechetLSH::FrechetLSH(Options options)
+    : options_(options)
+{
+    options_.tables = std::max(1, options_.tables);
+    cell_ = std::max(options_.cellFactor * options_.radius, 1e-12);
+
+    std::mt19937 rng(options_.seed);
+    std::uniform_real_distribution<double> shift(0.0, cell_);
+    for (int t = 0; t < options_.tables; ++t)
+        shifts_.emplace_back(shift(rng), shift(rng));
+
+    tables_.resize(options_.tables);
+}
+
+std::uint64_t FrechetLSH::hash(const Polyline& curve, int table) const
+{
+    const auto& [sx, sy] = shifts_[table];
+    std::uint64_t h = 0x84222325cbf29ce4ULL;
+    long long lastX = 0, lastY = 0;
+    bool hasLast = false;
+
+    for (const auto& p : curve.vertices) {
+        long long cx = static_cast<long long>(std::floor((p.x() + sx) / cell_));
+        long long cy = static_cast<long long>(std::floor((p.y() + sy) / cell_));
+        if (hasLast && cx == lastX && cy == lastY)
+            continue;
+
+        h = mix(h, static_cast<std::uint64_t>(cx));
+        h = mix(h, static_cast<std::uint64_t>(cy));
+        lastX = cx;
+        lastY = cy;
+        hasLast = true;
+    }
+
+    return h;
+}
+
+int FrechetLSH::add(PolylinePtr curve)
+{
+    int id = static_cast<int>(curves_.size());
+    for (int t = 0; t < options_.tables; ++t)
+        tables_[t].emplace_back(hash(*curve, t), id);
+    curves_.push_back(std::move(curve));
+    return id;
+}
+
+void FrechetLSH::build()
+{
+    for (auto& table : tables_)
+        std::sort(table.begin(), table.end());
+}
+
+std::vector<int> FrechetLSH::candidates(const Polyline& query) const
+{
+    std::vector<int> result;
+    for (int t = 0; t < options_.tables; ++t) {
+        std::uint64_t h = hash(query, t);
+        const auto& table = tables_[t];
+        auto it = std::lower_bound(table.begin(), table.end(), std::make_pair(h, -1));
+        for (; it != table.end() && it->first == h; ++it)
+            result.push_back(it->second);
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+bool FrechetLSH::within(const Polyline& query, const Polyline& curve, double eps) const
+{
+    thread_local Workspace workspace;
+    if (options_.metric == Metric::Discrete)
+        return discreteFrechetWithin(query, curve, eps, workspace.boundsScratch());
+
+    // candidates are one-off pairs, keep them out of the result cache
+    Decider decider(query, curve, &workspace);
+    decider.setCacheEnabled(false);
+    return decider.decide(eps).withinEps;
+}
+
+std::vector<int> FrechetLSH::query(const Polyline& query, double eps) const
+{
+    if (eps < 0.0)
+        eps = options_.radius;
+
+    std::vector<int> result;
+    for (int id : candidates(query))
+        if (within(query, *curves_[id], eps))
+            result.push_back(id);
+    return result;
+}
+
+int FrechetLSH::anyWithin(const Polyline& query, double eps) const
+{
+    if (eps < 0.0)
+        eps = options_.radius;
+
+    for (int id : candidates(query))
+        if (within(query, *curves_[id], eps))
+            return id;
+    return -1;
+}
+
+} // namespace Frechet
@@ -0,0 +1,61 @@
+#pragma once
+#include "Polyline.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Frechet {
+
+// Locality-sensitive hashing for Frechet near-neighbour queries
+// (Driemel & Silvestri). Each table snaps the vertices to a randomly
+// shifted grid, drops consecutive repeats and hashes the cell sequence;
+// curves within the query radius collide in some table with good
+// probability. A query touches only its own buckets, and every candidate
+// is verified with the exact decider.
+class FrechetLSH {
+public:
+    enum class Metric { Continuous, Discrete };
+
+    struct Options {
+        double radius = 1.0;     // query radius the tables are tuned for
+        double cellFactor = 4.0; // grid cell = cellFactor * radius
+        int tables = 8;
+        std::uint32_t seed = 1;
+        Metric metric = Metric::Continuous;
+    };
+
+    explicit FrechetLSH(Options options);
+
+    // returns the curve id (insertion order)
+    int add(PolylinePtr curve);
+
+    // sorts the tables; call after adding and before querying
+    void build();
+
+    inline int size() const { return static_cast<int>(curves_.size()); }
+    inline const PolylinePtr& curve(int id) const { return curves_[id]; }
+
+    // ids colliding with the query in at least one table, unverified
+    std::vector<int> candidates(const Polyline& query) const;
+
+    // verified ids within eps (defaults to the radius)
+    std::vector<int> query(const Polyline& query, double eps = -1.0) const;
+
+    // smallest verified id within eps, -1 if none; not the closest curve,
+    // verification stops at the first hit
+    int anyWithin(const Polyline& query, double eps = -1.0) const;
+
+private:
+    Options options_;
+    double cell_;
+    std::vector<std::pair<double, double>> shifts_; // per table
+
+    std::vector<PolylinePtr> curves_;
+    // per table: (hash, id), sorted by build()
+    std::vector<std::vector<std::pair<std::uint64_t, int>>> tables_;
+
+    std::uint64_t hash(const Polyline& curve, int table) const;
+    bool within(const Polyline& query, const Polyline& curve, double eps) const;
+};
+
+} // namespace Frechet
@@ -0,0 +1,359 @@
+#include "mapmatching.h"
+#include "bounds.h"
+#include "freespace.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace Frechet {
+
+void RoadGraph::build()
+{
+    incident.assign(vertices.size(), {});
+    for (int e = 0; e < static_cast<int>(edges.size()); ++e) {
+        incident[edges[e].first].push_back(e);
+        incident[edges[e].second].push_back(e);
+    }
+}
+
+static long long cellKey(long long cx, long long cy)
+{
+    return static_cast<long long>((static_cast<unsigned long long>(cx) << 32)
+                                  ^ (static_cast<unsigned long long>(cy) & 0xffffffffULL));
+}
+
+MapMatcher::MapMatcher(const RoadGraph& graph, const Polyline& trace)
+    : graph_(graph)
+    , trace_(trace)
+{
+    n_ = std::max(trace_.size() - 1, 0);
+    lowerBound_ = 0.0;
+    if (n_ == 0 || graph_.edges.empty())
+        return;
+
+    double maxX = -1e300, maxY = -1e300, length = 0.0;
+    minX_ = minY_ = 1e300;
+    for (int k = 0; k <= n_; ++k) {
+        const Point& p = trace_.vertices[k];
+        minX_ = std::min(minX_, p.x());
+        minY_ = std::min(minY_, p.y());
+        maxX = std::max(maxX, p.x());
+        maxY = std::max(maxY, p.y());
+        if (k > 0)
+            length += pointDistance(trace_.vertices[k - 1], p);
+    }
+
+    // about one segment per cell, bounded so huge traces keep a small grid
+    double diag = std::hypot(maxX - minX_, maxY - minY_);
+    cell_ = std::max({length / n_, diag / 2048.0, 1e-9});
+
+    for (int k = 0; k < n_; ++k) {
+        const Point& a = trace_.vertices[k];
+        const Point& b = trace_.vertices[k + 1];
+        long long x0 = static_cast<long long>(std::floor((std::min(a.x(), b.x()) - minX_) / cell_));
+        long long x1 = static_cast<long long>(std::floor((std::max(a.x(), b.x()) - minX_) / cell_));
+        long long y0 = static_cast<long long>(std::floor((std::min(a.y(), b.y()) - minY_) / cell_));
+        long long y1 = static_cast<long long>(std::floor((std::max(a.y(), b.y()) - minY_) / cell_));
+        for (long long cx = x0; cx <= x1; ++cx)
+            for (long long cy = y0; cy <= y1; ++cy)
+                grid_.emplace_back(cellKey(cx, cy), k);
+    }
+    std::sort(grid_.begin(), grid_.end());
+    seen_.assign(n_, 0);
+
+    const Point& first = trace_.vertices.front();
+    const Point& last = trace_.vertices.back();
+    double endDistance = 1e300;
+    for (int e = 0; e < static_cast<int>(graph_.edges.size()); ++e) {
+        const Point& a = graph_.vertices[graph_.edges[e].first];
+        const Point& b = graph_.vertices[graph_.edges[e].second];
+        startEdges_.emplace_back(pointSegmentDistance(first, a, b), e);
+        endDistance = std::min(endDistance, pointSegmentDistance(last, a, b));
+    }
+    std::sort(startEdges_.begin(), startEdges_.end());
+
+    // both ends of the trace must lie within eps of the graph
+    lowerBound_ = std::max(startEdges_.front().first, endDistance);
+}
+
+const std::vector<Interval>& MapMatcher::whiteIntervals(int v)
+{
+    auto it = white_.find(v);
+    if (it != white_.end())
+        return it->second;
+
+    const Point& p = graph_.vertices[v];
+    long long x0 = static_cast<long long>(std::floor((p.x() - eps_ - minX_) / cell_));
+    long long x1 = static_cast<long long>(std::floor((p.x() + eps_ - minX_) / cell_));
+    long long y0 = static_cast<long long>(std::floor((p.y() - eps_ - minY_) / cell_));
+    long long y1 = static_cast<long long>(std::floor((p.y() + eps_ - minY_) / cell_));
+
+    std::vector<int> segments;
+    ++stamp_;
+    for (long long cx = x0; cx <= x1; ++cx) {
+        for (long long cy = y0; cy <= y1; ++cy) {
+            long long key = cellKey(cx, cy);
+            auto g = std::lower_bound(grid_.begin(), grid_.end(), std::make_pair(key, -1));
+            for (; g != grid_.end() && g->first == key; ++g) {
+                if (seen_[g->second] != stamp_) {
+                    seen_[g->second] = stamp_;
+                    segments.push_back(g->second);
+                }
+            }
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+
+    // free parts per segment, merged where they touch across a trace vertex
+    std::vector<Interval> intervals;
+    for (int k : segments) {
+        Interval free = segmentPointInterval(trace_.vertices[k], trace_.vertices[k + 1], p, eps_);
+        if (free.isEmpty())
+            continue;
+
+        double start = k + free.start;
+        double end = k + free.end;
+        if (!intervals.empty() && intervals.back().end >= start - 1e-12)
+            intervals.back().end = std::max(intervals.back().end, end);
+        else
+            intervals.emplace_back(start, end);
+    }
+
+    return white_.emplace(v, std::move(intervals)).first->second;
+}
+
+double MapMatcher::scanEdge(const Point& u, const Point& v, double t0, double bottomEnd, Interval left)
+{
+    double finishS = -1.0;
+    reach_.clear();
+    int k0 = std::min(static_cast<int>(std::floor(t0)), n_ - 1);
+
+    for (int k = k0; k < n_; ++k) {
+        const Point& a = trace_.vertices[k];
+        const Point& b = trace_.vertices[k + 1];
+
+        // staying at u while the trace moves on: bottom edge of the strip
+        Interval bottom;
+        if (bottomEnd >= k) {
+            Interval free = segmentPointInterval(a, b, u, eps_);
+            double lo = std::max(free.start, t0 - k);
+            double hi = std::min(free.end, bottomEnd - k);
+            if (!free.isEmpty() && lo <= hi)
+                bottom = Interval(lo, hi);
+        }
+
+        Interval top = segmentPointInterval(a, b, v, eps_);
+        if (!top.isEmpty()) {
+            double low = std::numeric_limits<double>::infinity();
+            if (!left.isEmpty())
+                low = top.start;
+            if (!bottom.isEmpty())
+                low = std::min(low, std::max(top.start, bottom.start));
+            if (low <= top.end)
+                reach_.push_back(k + low);
+        }
+
+        Interval right = segmentPointInterval(u, v, b, eps_);
+        Interval rightReach;
+        if (!right.isEmpty()) {
+            if (!bottom.isEmpty())
+                rightReach = right;
+            else if (!left.isEmpty() && left.start <= right.end)
+                rightReach = Interval(std::max(left.start, right.start), right.end);
+        }
+
+        if (k == n_ - 1 && !rightReach.isEmpty())
+            finishS = rightReach.start;
+
+        left = rightReach;
+        if (left.isEmpty() && bottomEnd < k + 1)
+            break;
+    }
+
+    return finishS;
+}
+
+bool MapMatcher::decide(double eps, Match* match)
+{
+    settled_ = 0;
+    if (n_ == 0 || graph_.edges.empty() || eps < lowerBound_)
+        return false;
+
+    eps_ = eps;
+    white_.clear();
+
+    struct Node {
+        int vertex;
+        int interval;
+    };
+    struct Pred {
+        int vertex = -1;   // previous vertex, -1: entered from a start edge
+        int interval = -1;
+        QPointF start;     // start point when vertex == -1
+    };
+    struct Queued {
+        double t;
+        int vertex;
+        int interval;
+        bool operator>(const Queued& o) const { return t > o.t; }
+    };
+
+    // both ids are non-negative ints, so the key is unique
+    auto nodeKey = [](int vertex, int interval) {
+        return static_cast<long long>(vertex) * (1LL << 32) + interval;
+    };
+
+    std::unordered_map<long long, double> best;
+    std::unordered_map<long long, Pred> pred;
+    std::priority_queue<Queued, std::vector<Queued>, std::greater<Queued>> queue;
+
+    bool found = false;
+    Node last{-1, -1};
+    QPointF startPoint, endPoint;
+
+    // record the lowest parameter at which the path reaches w
+    auto relax = [&](int w, double t, const Pred& from) {
+        const auto& intervals = whiteIntervals(w);
+        auto it = std::upper_bound(intervals.begin(), intervals.end(), t + 1e-9,
+                                   [](double value, const Interval& I) { return value < I.start; });
+        if (it == intervals.begin())
+            return;
+        --it;
+        if (t > it->end + 1e-9)
+            return;
+
+        int index = static_cast<int>(it - intervals.begin());
+        long long key = nodeKey(w, index);
+        auto b = best.find(key);
+        if (b != best.end() && b->second <= t)
+            return;
+
+        best[key] = t;
+        pred[key] = from;
+        queue.push({t, w, index});
+    };
+
+    // paths may start anywhere on an edge near the trace start
+    for (const auto& [distance, e] : startEdges_) {
+        if (distance > eps)
+            break;
+
+        for (int dir = 0; dir < 2 && !found; ++dir) {
+            int a = dir == 0 ? graph_.edges[e].first : graph_.edges[e].second;
+            int b = dir == 0 ? graph_.edges[e].second : graph_.edges[e].first;
+            const Point& pa = graph_.vertices[a];
+            const Point& pb = graph_.vertices[b];
+
+            Interval left = segmentPointInterval(pa, pb, trace_.vertices.front(), eps);
+            if (left.isEmpty())
+                continue;
+
+            Pred from;
+            from.start = pa + left.start * (pb - pa);
+
+            double finishS = scanEdge(pa, pb, 0.0, -1.0, left);
+            if (finishS >= 0.0) {
+                found = true;
+                startPoint = from.start;
+                endPoint = pa + finishS * (pb - pa);
+            } else {
+                for (double t : reach_)
+                    relax(b, t, from);
+            }
+        }
+        if (found)
+            break;
+    }
+
+    while (!found && !queue.empty()) {
+        Queued q = queue.top();
+        queue.pop();
+        if (best[nodeKey(q.vertex, q.interval)] < q.t)
+            continue;
+
+        ++settled_;
+        const Interval& white = whiteIntervals(q.vertex)[q.interval];
+        const Point& pu = graph_.vertices[q.vertex];
+
+        if (white.end >= n_ - 1e-12) {
+            found = true;
+            last = {q.vertex, q.interval};
+            endPoint = pu;
+            break;
+        }
+
+        for (int e : graph_.incident[q.vertex]) {
+            int w = graph_.edges[e].first == q.vertex ? graph_.edges[e].second : graph_.edges[e].first;
+            const Point& pw = graph_.vertices[w];
+
+            double finishS = scanEdge(pu, pw, q.t, white.end, Interval());
+            if (finishS >= 0.0) {
+                found = true;
+                last = {q.vertex, q.interval};
+                endPoint = pu + finishS * (pw - pu);
+                break;
+            }
+
+            Pred from;
+            from.vertex = q.vertex;
+            from.interval = q.interval;
+            for (double t : reach_)
+                relax(w, t, from);
+        }
+    }
+
+    if (found && match) {
+        match->found = true;
+        match->eps = eps;
+        match->vertices.clear();
+        match->path.clear();
+
+        Node node = last;
+        while (node.vertex >= 0) {
+            match->vertices.push_back(node.vertex);
+            const Pred& p = pred[nodeKey(node.vertex, node.interval)];
+            if (p.vertex < 0)
+                startPoint = p.start;
+            node = {p.vertex, p.interval};
+        }
+        std::reverse(match->vertices.begin(), match->vertices.end());
+
+        match->path.push_back(startPoint);
+        for (int v : match->vertices)
+            match->path.push_back(graph_.vertices[v]);
+        match->path.push_back(endPoint);
+    }
+
+    return found;
+}
+
+MapMatcher::Match MapMatcher::match(double tolerance)
+{
+    Match result;
+    if (n_ == 0 || graph_.edges.empty())
+        return result;
+
+    double lo = lowerBound_;
+    double hi = std::max(lowerBound_, 1e-9);
+    for (int it = 0; it < 64 && !decide(hi); ++it)
+        hi *= 2.0;
+
+    if (!decide(hi, &result))
+        return result;
+
+    while (hi - lo > tolerance * std::max(hi, 1e-12)) {
+        double mid = 0.5 * (lo + hi);
+        Match m;
+        if (decide(mid, &m)) {
+            hi = mid;
+            result = std::move(m);
+        } else {
+            lo = mid;
+        }
+    }
+
+    return result;
+}
+
+} // namespace Frechet
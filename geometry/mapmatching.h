@@ -0,0 +1,72 @@
+#pragma once
+#include "FrechetCell.h"
+#include "Polyline.h"
+#include "roadgraph.h"
+#include <QPointF>
+#include <unordered_map>
+#include <vector>
+
+namespace Frechet {
+
+// Path in a road graph with minimum Frechet distance to a trace
+// (Alt, Efrat, Rote, Wenk). Each edge carries a one-cell-high free space
+// strip against the trace; each vertex carries its free intervals of the
+// trace parameter. A Dijkstra-like sweep settles (vertex, interval) pairs
+// by the lowest reachable trace parameter, so only the part of the graph
+// near the trace is ever touched. A grid over the trace segments finds
+// the free intervals of a vertex without scanning the whole trace.
+class MapMatcher {
+public:
+    struct Match {
+        bool found = false;
+        double eps = 0.0;
+        std::vector<int> vertices;  // graph vertices in path order
+        std::vector<QPointF> path;  // start point, vertices, end point
+    };
+
+    MapMatcher(const RoadGraph& graph, const Polyline& trace);
+
+    // is there a graph path within eps of the whole trace?
+    bool decide(double eps, Match* match = nullptr);
+
+    // smallest eps (relative tolerance) and its path
+    Match match(double tolerance = 1e-3);
+
+    inline int settledCount() const { return settled_; }
+
+private:
+    const RoadGraph& graph_;
+    const Polyline& trace_;
+    int n_; // trace segments
+
+    // trace segments by grid cell, sorted (cell key, segment)
+    double cell_;
+    double minX_, minY_;
+    std::vector<std::pair<long long, int>> grid_;
+    std::vector<int> seen_;
+    int stamp_ = 0;
+
+    // edges sorted by distance to the trace start
+    std::vector<std::pair<double, int>> startEdges_;
+    double lowerBound_;
+
+    // per decision
+    double eps_ = 0.0;
+    std::unordered_map<int, std::vector<Interval>> white_;
+    int settled_ = 0;
+
+    // lowest trace parameter at the far vertex, per strip cell where it
+    // is reachable (one visit of the trace may span several cells)
+    std::vector<double> reach_;
+
+    // free intervals (trace parameter) of a graph vertex
+    const std::vector<Interval>& whiteIntervals(int v);
+
+    // propagate through the strip of u -> v, entering at the vertex u at
+    // trace parameter t0 (free until bottomEnd) or on the left side of
+    // the first cell with the edge interval `left`. Fills reach_ and
+    // returns the edge parameter where the trace ends, or -1
+    double scanEdge(const Point& u, const Point& v, double t0, double bottomEnd, Interval left);
+};
+
+} // namespace Frechet
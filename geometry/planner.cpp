@@ -0,0 +1,182 @@
+#include "planner.h"
+#include "batchdecider.h"
+#include "bounds.h"
+#include "decider.h"
+#include "epstimeline.h"
+#include "freespace.h"
+#include "resultcache.h"
+#include <QDebug>
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+Q_LOGGING_CATEGORY(lcPlanner, "frechet.planner")
+
+namespace Frechet {
+
+// LocalMatching on top of the cell matrix: two cached vertex-edge
+// distances and four edge buffers per cell
+static const qint64 MatchingBytesPerCell = 2 * 2 * sizeof(double) + 4 * sizeof(Interval);
+
+Planner::Planner(const Polyline& P, const Polyline& Q)
+    : Planner(P, Q, Options())
+{
+}
+
+Planner::Planner(const Polyline& P, const Polyline& Q, const Options& options)
+    : P_(P), Q_(Q), options_(options)
+{
+    if (options_.memoryBudget <= 0)
+        options_.memoryBudget = availableMemory() / 2;
+
+    cells_ = static_cast<qint64>(std::max(P.size() - 1, 0)) * std::max(Q.size() - 1, 0);
+    lower_ = endpointLowerBound(P, Q);
+    upper_ = greedyUpperBound(P, Q);
+}
+
+qint64 Planner::bytes(Engine engine) const
+{
+    // BatchDecider keeps per lane two doubles for every row, plus the
+    // first column's edge quadratics
+    auto rows = [&](int lanes) {
+        return static_cast<qint64>(Q_.size()) * (2 * lanes * sizeof(double) + 4 * sizeof(double));
+    };
+
+    switch (engine) {
+    case Engine::Bounds:        return 0;
+    case Engine::FreeSpace:     return cells_ * static_cast<qint64>(sizeof(FrechetCell));
+    case Engine::Linear:        return rows(1);
+    case Engine::Timeline:      return 2 * cells_ * static_cast<qint64>(sizeof(EpsTimeline::Event) + sizeof(double))
+                                       + rows(BatchDecider::DefaultLanes);
+    case Engine::Bisection:     return rows(BatchDecider::DefaultLanes);
+    case Engine::LocalMatching: return cells_ * (static_cast<qint64>(sizeof(FrechetCell)) + MatchingBytesPerCell);
+    case Engine::Tiled:         return static_cast<qint64>(options_.tileSize) * options_.tileSize * sizeof(FrechetCell);
+    }
+    return 0;
+}
+
+Planner::Plan Planner::plan(Query query, double eps) const
+{
+    Engine engine = Engine::Bounds;
+    const char* name = "";
+    switch (query) {
+    case Query::Decision:
+        name = "decision";
+        if (lower_ > eps || upper_ <= eps)
+            engine = Engine::Bounds;
+        else
+            engine = fits(Engine::FreeSpace) ? Engine::FreeSpace : Engine::Linear;
+        break;
+    case Query::Distance:
+        name = "distance";
+        if (upper_ <= lower_)
+            engine = Engine::Bounds;
+        else
+            engine = fits(Engine::Timeline) ? Engine::Timeline : Engine::Bisection;
+        break;
+    case Query::Matching:
+        name = "matching";
+        if (lower_ > eps)
+            engine = Engine::Bounds;
+        else
+            engine = fits(Engine::LocalMatching) ? Engine::LocalMatching : Engine::Tiled;
+        break;
+    }
+
+    Plan plan{engine, cells_, bytes(engine)};
+    qCInfo(lcPlanner).noquote() << QString("%1, %2 x %3 vertices, eps %4: %5 (%6 of %7 MiB)")
+                                       .arg(name).arg(P_.size()).arg(Q_.size()).arg(eps)
+                                       .arg(engineName(engine)).arg(plan.bytes >> 20)
+                                       .arg(options_.memoryBudget >> 20);
+    return plan;
+}
+
+bool Planner::decide(double eps)
+{
+    switch (plan(Query::Decision, eps).engine) {
+    case Engine::FreeSpace:
+        return Decider(P_, Q_, &workspace_).decide(eps).withinEps;
+    case Engine::Linear:
+        return BatchDecider(P_, Q_).decide({eps}).front() != 0;
+    default:
+        return upper_ <= eps;
+    }
+}
+
+double Planner::distance()
+{
+    switch (plan(Query::Distance).engine) {
+    case Engine::Timeline:
+        return EpsTimeline(P_, Q_).criticalEps();
+    case Engine::Bisection: {
+        // an exact distance from an earlier run beats the bisection
+        double cached;
+        if (ResultCache::instance().findDistance(ResultCache::key(P_, Q_), cached))
+            return cached;
+        return BatchDecider(P_, Q_).narrow(lower_, upper_, options_.tolerance);
+    }
+    default:
+        return upper_;
+    }
+}
+
+std::vector<QPointF> Planner::matching(double eps)
+{
+    std::vector<QPointF> path;
+    switch (plan(Query::Matching, eps).engine) {
+    case Engine::LocalMatching: {
+        FreeSpace& fs = workspace_.freeSpace(P_, Q_, eps);
+        fs.computeReachability();
+        fs.computeCriticalPath(path);
+        break;
+    }
+    case Engine::Tiled: {
+        TiledFreeSpace fs(P_, Q_, eps, options_.tileSize);
+        if (!options_.scratchDirectory.isEmpty())
+            fs.setScratchDirectory(options_.scratchDirectory);
+        if (fs.compute())
+            fs.computeCriticalPath(path);
+        break;
+    }
+    default:
+        break;
+    }
+    return path;
+}
+
+QString Planner::engineName(Engine engine)
+{
+    switch (engine) {
+    case Engine::Bounds:        return "bounds";
+    case Engine::FreeSpace:     return "free space";
+    case Engine::Linear:        return "linear";
+    case Engine::Timeline:      return "timeline";
+    case Engine::Bisection:     return "bisection";
+    case Engine::LocalMatching: return "local matching";
+    case Engine::Tiled:         return "tiled";
+    }
+    return QString();
+}
+
+qint64 Planner::availableMemory()
+{
+#if defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status))
+        return static_cast<qint64>(status.ullAvailPhys);
+#elif defined(_SC_AVPHYS_PAGES)
+    long pages = sysconf(_SC_AVPHYS_PAGES);
+    long size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && size > 0)
+        return static_cast<qint64>(pages) * size;
+#endif
+    return qint64(1) << 30;
+}
+
+} // namespace Frechet
@@ -0,0 +1,81 @@
+#pragma once
+#include "Polyline.h"
+#include "tiledfreespace.h"
+#include "workspace.h"
+#include <QLoggingCategory>
+#include <QPointF>
+#include <QString>
+#include <vector>
+
+Q_DECLARE_LOGGING_CATEGORY(lcPlanner)
+
+namespace Frechet {
+
+// Picks the cheapest engine that can answer a query for a pair, from the
+// curve sizes, the O(m + n) bounds and a memory budget, and runs it. Every
+// choice is logged under "frechet.planner", e.g.
+//   QT_LOGGING_RULES="frechet.planner.info=true"
+class Planner {
+public:
+    enum class Query {
+        Decision, // d_F <= eps?
+        Distance, // d_F
+        Matching  // a matching within eps
+    };
+
+    enum class Engine {
+        Bounds,        // endpoint and greedy bounds alone
+        FreeSpace,     // Decider: filters, cache, cell matrix in memory
+        Linear,        // BatchDecider: one row of reachability, O(n) memory
+        Timeline,      // EpsTimeline: exact, over the critical events
+        Bisection,     // BatchDecider bisection between the bounds, O(n) memory
+        LocalMatching, // FreeSpace with the locally correct matching
+        Tiled          // TiledFreeSpace: border intervals in a scratch file
+    };
+
+    struct Options {
+        qint64 memoryBudget = 0; // 0: half of the free physical memory
+        double tolerance = 1e-9; // relative, for Bisection
+        int tileSize = TiledFreeSpace::DefaultTileSize;
+        QString scratchDirectory; // for Tiled, temp directory if empty
+    };
+
+    struct Plan {
+        Engine engine;
+        qint64 cells;
+        qint64 bytes; // estimated working memory
+    };
+
+    Planner(const Polyline& P, const Polyline& Q);
+    Planner(const Polyline& P, const Polyline& Q, const Options& options);
+
+    // eps is ignored for Query::Distance
+    Plan plan(Query query, double eps = 0.0) const;
+
+    // the engine's working memory is within the budget
+    inline bool fits(Engine engine) const { return bytes(engine) <= options_.memoryBudget; }
+
+    bool decide(double eps);
+    double distance();
+    // empty if d_F > eps
+    std::vector<QPointF> matching(double eps);
+
+    static QString engineName(Engine engine);
+
+    // free physical memory, 1 GiB where the platform does not tell
+    static qint64 availableMemory();
+
+private:
+    const Polyline& P_;
+    const Polyline& Q_;
+    Options options_;
+    Workspace workspace_;
+
+    qint64 cells_;
+    double lower_; // endpoint bound
+    double upper_; // greedy walk bound
+
+    qint64 bytes(Engine engine) const;
+};
+
+} // namespace Frechet
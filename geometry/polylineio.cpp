@@ -0,0 +1,214 @@
+#include "polylineio.h"
+#include <QFile>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <QDebug>
+
+bool readPolylines(const QString& fileName, Polyline& P, Polyline& Q)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Cannot open file:" << fileName;
+        return false;
+    }
+
+    QTextStream in(&file);
+
+    Polyline newP, newQ;
+    Polyline* current = nullptr;
+
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+
+        if (line.isEmpty())
+            continue;
+
+        if (line == "P") {
+            current = &newP;
+            continue;
+        }
+
+        if (line == "Q") {
+            current = &newQ;
+            continue;
+        }
+
+        if (!current) {
+            qWarning() << "Point without polyline header:" << line;
+            continue;
+        }
+
+        QStringList parts = line.split(QRegularExpression("\\s+"));
+        if (parts.size() != 2) {
+            qWarning() << "Invalid line:" << line;
+            continue;
+        }
+
+        bool okX, okY;
+        double x = parts[0].toDouble(&okX);
+        double y = parts[1].toDouble(&okY);
+
+        if (!okX || !okY) {
+            qWarning() << "Invalid coordinates:" << line;
+            continue;
+        }
+
+        current->vertices.emplace_back(x, y);
+    }
+
+    if (newP.vertices.size() < 2 || newQ.vertices.size() < 2) {
+        qWarning() << "Each polyline must have at least 2 points";
+        return false;
+    }
+
+    P = std::move(newP);
+    Q = std::move(newQ);
+    return true;
+}
+
+bool readCurveSet(const QString& fileName, std::vector<Polyline>& curves)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Cannot open file:" << fileName;
+        return false;
+    }
+
+    QTextStream in(&file);
+
+    std::vector<Polyline> result;
+    bool open = false;
+    bool valid = true;
+
+    // dropping the curve would shift the indices of every later one
+    auto close = [&]() {
+        if (open && result.back().vertices.size() < 2) {
+            qWarning() << "Curve" << result.size() - 1 << "in" << fileName << "has less than 2 points";
+            valid = false;
+        }
+        open = false;
+    };
+
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        QStringList parts = line.split(QRegularExpression("\\s+"));
+        bool okX = false, okY = false;
+        double x = 0.0, y = 0.0;
+        if (parts.size() == 2) {
+            x = parts[0].toDouble(&okX);
+            y = parts[1].toDouble(&okY);
+        }
+
+        if (!okX || !okY) {
+            // header line
+            close();
+            result.emplace_back();
+            open = true;
+            continue;
+        }
+
+        if (!open) {
+            qWarning() << "Point without curve header:" << line;
+            continue;
+        }
+
+        result.back().vertices.emplace_back(x, y);
+    }
+    close();
+
+    if (!valid)
+        return false;
+    if (result.empty()) {
+        qWarning() << "No curves in" << fileName;
+        return false;
+    }
+
+    curves = std::move(result);
+    return true;
+}
+
+bool writeCurveSet(const QString& fileName, const std::vector<Polyline>& curves, const QString& comment)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Cannot write file:" << fileName;
+        return false;
+    }
+
+    QTextStream out(&file);
+    out.setRealNumberPrecision(17);
+
+    if (!comment.isEmpty())
+        for (const QString& line : comment.split('\n'))
+            out << "# " << line << "\n";
+
+    for (size_t c = 0; c < curves.size(); ++c) {
+        if (curves.size() == 2)
+            out << (c == 0 ? "P" : "Q") << "\n";
+        else
+            out << "C" << c << "\n";
+
+        for (const auto& p : curves[c].vertices)
+            out << p.x() << " " << p.y() << "\n";
+    }
+
+    return out.status() == QTextStream::Ok;
+}
+
+bool readRoadGraph(const QString& fileName, Frechet::RoadGraph& graph)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Cannot open file:" << fileName;
+        return false;
+    }
+
+    QTextStream in(&file);
+    Frechet::RoadGraph result;
+
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        QStringList parts = line.split(QRegularExpression("\\s+"));
+        if (parts.size() != 3 || (parts[0] != "v" && parts[0] != "e")) {
+            qWarning() << "Invalid line:" << line;
+            continue;
+        }
+
+        bool okA, okB;
+        if (parts[0] == "v") {
+            double x = parts[1].toDouble(&okA);
+            double y = parts[2].toDouble(&okB);
+            if (!okA || !okB) {
+                qWarning() << "Invalid coordinates:" << line;
+                continue;
+            }
+            result.vertices.emplace_back(x, y);
+        } else {
+            int a = parts[1].toInt(&okA);
+            int b = parts[2].toInt(&okB);
+            int count = static_cast<int>(result.vertices.size());
+            if (!okA || !okB || a < 0 || b < 0 || a >= count || b >= count || a == b) {
+                qWarning() << "Invalid edge:" << line;
+                continue;
+            }
+            result.edges.emplace_back(a, b);
+        }
+    }
+
+    if (result.edges.empty()) {
+        qWarning() << "Road graph has no edges:" << fileName;
+        return false;
+    }
+
+    result.build();
+    graph = std::move(result);
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "Polyline.h"
+#include "roadgraph.h"
+#include <QString>
+
+// Reads the "P / Q" text format (see examples/), returns false and logs
+// a warning if the file cannot be read or a polyline has < 2 vertices
+bool readPolylines(const QString& fileName, Polyline& P, Polyline& Q);
+
+// Reads a set of curves: every non-numeric line (e.g. "P", "T17") starts a
+// new curve, lines starting with '#' are comments. A curve with < 2 vertices
+// fails the read, so curve indices always follow the file order.
+bool readCurveSet(const QString& fileName, std::vector<Polyline>& curves);
+
+// Writes curves in the curve-set format, `comment` lines first as '#'
+// comments. Two curves are named P and Q so readPolylines accepts them.
+bool writeCurveSet(const QString& fileName, const std::vector<Polyline>& curves, const QString& comment = QString());
+
+// Reads a road graph: "v x y" adds a vertex (ids count from 0 in file
+// order), "e a b" an edge between vertex ids, '#' starts a comment
+bool readRoadGraph(const QString& fileName, Frechet::RoadGraph& graph);
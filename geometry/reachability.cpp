@@ -1,18 +1,23 @@
 #include "reachability.h"
 #include <algorithm>
+#include <limits>
 
 namespace Frechet {
 
-Reachability::Reachability(FreeSpace& fs) : fs_(fs) {}
+Reachability::Reachability(FreeSpace& fs, Mode mode) : fs_(fs), mode_(mode) {}
 
 void Reachability::compute() {
     int m = fs_.getM();
     int n = fs_.getN();
 
+    if (m == 0 || n == 0)
+        return;
+
     auto& cells = fs_.getCells();
+    bool subtrajectory = mode_ == Mode::Subtrajectory;
 
     // calculate for bottom left cell
-    if (cells[0][0].bottom.contains(0.0))
+    if (subtrajectory || cells[0][0].bottom.contains(0.0))
         cells[0][0].reachableBottom = cells[0][0].bottom;
     else
         cells[0][0].reachableBottom = Interval();
@@ -23,8 +28,11 @@ void Reachability::compute() {
         cells[0][0].reachableLeft = Interval();
 
     // calculate for the rest of the bottom row
+    // (a subtrajectory may start anywhere on it)
     for (int i = 1; i < m; ++i) {
-        if (cells[i-1][0].reachableBottom.contains(1.0) && cells[i][0].bottom.contains(0.0))
+        if (subtrajectory)
+            cells[i][0].reachableBottom = cells[i][0].bottom;
+        else if (cells[i-1][0].reachableBottom.contains(1.0) && cells[i][0].bottom.contains(0.0))
             cells[i][0].reachableBottom = cells[i][0].bottom;
         else
             cells[i][0].reachableBottom = Interval();
@@ -38,41 +46,171 @@ void Reachability::compute() {
             cells[0][j].reachableLeft = Interval();
     }
 
+    // subtrajectory start ranges, per reachable interval of the left
+    // edges of the current column and of the bottom edge of the current
+    // cell; the left column is only reached from the start at 0
+    std::vector<Starts> leftStarts(subtrajectory ? n : 0);
+    std::vector<Starts> topStarts(subtrajectory ? m : 0);
+    Starts bottomStarts, top, right;
+    for (int j = 0; j < static_cast<int>(leftStarts.size()); ++j)
+        if (!cells[0][j].reachableLeft.isEmpty())
+            leftStarts[j].push_back({j + cells[0][j].reachableLeft.start, 0.0, 0.0, 0.0});
+
+    // a start may also slide along the bottom edge into the next cell
+    double chainFirst = -1.0;
+    const double infinity = std::numeric_limits<double>::infinity();
+
     // calculate for the rest of the cells
     for (int i = 0; i < m; ++i) {
+        if (subtrajectory) {
+            // a bottom point is its own latest start
+            const Interval& bottom = cells[i][0].reachableBottom;
+            bottomStarts.clear();
+            if (!bottom.isEmpty()) {
+                double first = i + bottom.start;
+                if (i > 0 && chainFirst >= 0.0 && bottom.contains(0.0))
+                    first = chainFirst;
+                bottomStarts.push_back({i + bottom.start, first, -infinity, infinity});
+                chainFirst = bottom.contains(1.0) ? first : -1.0;
+            } else {
+                chainFirst = -1.0;
+            }
+        }
+
         for (int j = 0; j < n; ++j) {
             FrechetCell& c = cells[i][j];
 
-            // reachableTop
-            c.reachableTop = computeTopReachable(c);
-            if (j < n - 1)
-                cells[i][j+1].reachableBottom = c.reachableTop;
-            if (!c.reachableLeft.isEmpty()) {
-                c.predTop = FrechetCell::PredOrigin::Left;
-            } else if (!c.reachableBottom.isEmpty()) {
-                c.predTop = FrechetCell::PredOrigin::Bottom;
-            } else {
-                c.predTop = FrechetCell::PredOrigin::None;
-            }
+            propagateCell(i, j);
 
-            // reachableRight
-            c.reachableRight = computeRightReachable(c);
-            if (i < m - 1)
-                cells[i+1][j].reachableLeft = c.reachableRight;
-            if (!c.reachableLeft.isEmpty())
-                c.predRight = FrechetCell::PredOrigin::Left;
-            else if (!c.reachableBottom.isEmpty())
-                c.predRight = FrechetCell::PredOrigin::Bottom;
-            else
-                c.predRight = FrechetCell::PredOrigin::None;
+            if (subtrajectory) {
+                // every left point reaches the whole top, bottom points
+                // the top from their own position on; the same with the
+                // roles swapped for the right edge
+                combine(top, c.reachableTop, i, c.reachableLeft, j, leftStarts[j],
+                        c.reachableBottom, i, bottomStarts);
+                combine(right, c.reachableRight, j, c.reachableBottom, i, bottomStarts,
+                        c.reachableLeft, j, leftStarts[j]);
+                std::swap(bottomStarts, top);
+                std::swap(leftStarts[j], right);
+            }
         }
+
+        if (subtrajectory)
+            topStarts[i] = bottomStarts;
+    }
+
+    matches_.clear();
+    starts_.clear();
+    if (subtrajectory) {
+        collectMatches(topStarts);
+        collectStarts();
+    }
+}
+
+void Reachability::extendP() {
+    int m = fs_.getM();
+    int n = fs_.getN();
+    if (m < 2) {
+        compute();
+        return;
+    }
+
+    auto& cells = fs_.getCells();
+    int i = m - 1;
+
+    // reachableLeft was pushed by the previous row's reachableRight only
+    // for cells that existed, so pull it from there
+    for (int j = 0; j < n; ++j)
+        cells[i][j].reachableLeft = cells[i-1][j].reachableRight;
+
+    if (cells[i-1][0].reachableBottom.contains(1.0) && cells[i][0].bottom.contains(0.0))
+        cells[i][0].reachableBottom = cells[i][0].bottom;
+    else
+        cells[i][0].reachableBottom = Interval();
+
+    for (int j = 0; j < n; ++j)
+        propagateCell(i, j);
+}
+
+void Reachability::extendQ() {
+    int m = fs_.getM();
+    int n = fs_.getN();
+    if (n < 2) {
+        compute();
+        return;
+    }
+
+    auto& cells = fs_.getCells();
+    int j = n - 1;
+
+    for (int i = 0; i < m; ++i)
+        cells[i][j].reachableBottom = cells[i][j-1].reachableTop;
+
+    if (cells[0][j-1].reachableLeft.contains(1.0) && cells[0][j].left.contains(0.0))
+        cells[0][j].reachableLeft = cells[0][j].left;
+    else
+        cells[0][j].reachableLeft = Interval();
+
+    for (int i = 0; i < m; ++i)
+        propagateCell(i, j);
+}
+
+void Reachability::computeFrom(const std::vector<Interval>& left, const std::vector<Interval>& bottom) {
+    int m = fs_.getM();
+    int n = fs_.getN();
+    auto& cells = fs_.getCells();
+
+    for (int j = 0; j < n; ++j)
+        cells[0][j].reachableLeft = left[j];
+    for (int i = 0; i < m; ++i)
+        cells[i][0].reachableBottom = bottom[i];
+
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j)
+            propagateCell(i, j);
+
+    matches_.clear();
+}
+
+void Reachability::propagateCell(int i, int j) {
+    int m = fs_.getM();
+    int n = fs_.getN();
+
+    auto& cells = fs_.getCells();
+    FrechetCell& c = cells[i][j];
+
+    propagate(c);
+    if (j < n - 1)
+        cells[i][j+1].reachableBottom = c.reachableTop;
+    if (i < m - 1)
+        cells[i+1][j].reachableLeft = c.reachableRight;
+}
+
+void Reachability::propagate(FrechetCell& c) {
+    // reachableTop
+    c.reachableTop = computeTopReachable(c);
+    if (!c.reachableLeft.isEmpty()) {
+        c.predTop = FrechetCell::PredOrigin::Left;
+    } else if (!c.reachableBottom.isEmpty()) {
+        c.predTop = FrechetCell::PredOrigin::Bottom;
+    } else {
+        c.predTop = FrechetCell::PredOrigin::None;
     }
+
+    // reachableRight
+    c.reachableRight = computeRightReachable(c);
+    if (!c.reachableLeft.isEmpty())
+        c.predRight = FrechetCell::PredOrigin::Left;
+    else if (!c.reachableBottom.isEmpty())
+        c.predRight = FrechetCell::PredOrigin::Bottom;
+    else
+        c.predRight = FrechetCell::PredOrigin::None;
 }
 
-Interval Reachability::computeTopReachable(const FrechetCell& cell) {
+inline Interval Reachability::computeTopReachable(const FrechetCell& cell) {
     if (!cell.reachableLeft.isEmpty()) {
         return cell.top;
-    } else if (!cell.reachableBottom.isEmpty()) {
+    } else if (!cell.reachableBottom.isEmpty() && !cell.top.isEmpty()) {
         double s = std::max(cell.reachableBottom.start, cell.top.start);
         double e = cell.top.end;
         return Interval(s,e);
@@ -81,10 +219,10 @@ Interval Reachability::computeTopReachable(const FrechetCell& cell) {
     }
 }
 
-Interval Reachability::computeRightReachable(const FrechetCell& cell) {
+inline Interval Reachability::computeRightReachable(const FrechetCell& cell) {
     if (!cell.reachableBottom.isEmpty()) {
         return cell.right;
-    } else if (!cell.reachableLeft.isEmpty()) {
+    } else if (!cell.reachableLeft.isEmpty() && !cell.right.isEmpty()) {
         double s = std::max(cell.reachableLeft.start, cell.right.start);
         double e = cell.right.end;
         return Interval(s,e);
@@ -93,4 +231,147 @@ Interval Reachability::computeRightReachable(const FrechetCell& cell) {
     }
 }
 
+void Reachability::combine(Starts& out, const Interval& edge, double offset,
+                           const Interval& whole, double wholeOffset, const Starts& wholeStarts,
+                           const Interval& along, double alongOffset, const Starts& alongStarts) {
+    // edge is reached from every point of `whole` and from the points of
+    // `along` up to the same position; the starts grow along an interval,
+    // so all of `whole` counts as its last point and `along` as its last
+    // point up to the position
+    out.clear();
+    if (edge.isEmpty())
+        return;
+
+    double from = offset + edge.start;
+    double to = offset + edge.end;
+
+    bool hasWhole = !whole.isEmpty() && !wholeStarts.empty();
+    double wholeFirst = 0.0, wholeLatest = 0.0;
+    if (hasWhole) {
+        const StartPiece& last = wholeStarts.back();
+        wholeFirst = last.first;
+        wholeLatest = std::max(last.lo, std::min(wholeOffset + whole.end, last.hi));
+    }
+
+    auto append = [&out](const StartPiece& piece) {
+        if (!out.empty() && out.back().first == piece.first
+            && out.back().lo == piece.lo && out.back().hi == piece.hi)
+            return;
+        out.push_back(piece);
+    };
+
+    // below the first point of `along` only `whole` reaches the edge
+    bool hasAlong = !along.isEmpty() && !alongStarts.empty();
+    if (hasWhole && (!hasAlong || from < alongStarts.front().at))
+        append({from, wholeFirst, wholeLatest, wholeLatest});
+    if (!hasAlong)
+        return;
+
+    double alongEnd = alongOffset + along.end;
+    for (size_t k = 0; k < alongStarts.size(); ++k) {
+        StartPiece piece = alongStarts[k];
+        if (piece.at > to)
+            break;
+        if (k + 1 < alongStarts.size() && alongStarts[k + 1].at <= from)
+            continue;
+
+        // points past the end of `along` are reached from its end only
+        piece.at = std::max(piece.at, from);
+        piece.hi = std::min(piece.hi, std::max(piece.lo, alongEnd));
+        if (hasWhole) {
+            piece.first = std::min(piece.first, wholeFirst);
+            piece.lo = std::max(piece.lo, wholeLatest);
+            piece.hi = std::max(piece.hi, wholeLatest);
+        }
+        append(piece);
+    }
+}
+
+void Reachability::collectMatches(const std::vector<Starts>& topStarts) {
+    int m = fs_.getM();
+    int n = fs_.getN();
+    const auto& cells = fs_.getCells();
+
+    for (int i = 0; i < m; ++i) {
+        const Interval& top = cells[i][n-1].reachableTop;
+        const Starts& pieces = topStarts[i];
+        if (top.isEmpty() || pieces.empty())
+            continue;
+
+        for (size_t k = 0; k < pieces.size(); ++k) {
+            const StartPiece& p = pieces[k];
+            double endStart = p.at;
+            double endEnd = k + 1 < pieces.size() ? pieces[k + 1].at : i + top.end;
+            double start = std::max(p.lo, std::min(endStart, p.hi));
+            double latest = std::max(p.lo, std::min(endEnd, p.hi));
+
+            // the same piece continuing into the next cell extends the previous match
+            if (!matches_.empty()
+                && matches_.back().endEnd == endStart
+                && matches_.back().earliestStart == p.first
+                && matches_.back().latestStart == start) {
+                matches_.back().endEnd = endEnd;
+                matches_.back().latestStart = latest;
+                continue;
+            }
+
+            matches_.push_back({start, endStart, endEnd, p.first, latest});
+        }
+    }
+}
+
+void Reachability::collectStarts() {
+    int m = fs_.getM();
+    int n = fs_.getN();
+    const auto& cells = fs_.getCells();
+
+    // backward reachability from the whole top edge: a bottom point reaches
+    // all of the right side and the top from its own position on, a left
+    // point all of the top and the right side from its own height on
+    std::vector<Interval> backLeft(n);
+    std::vector<Interval> backBottom(m);
+    Interval chain; // right edge of the diagram, sliding up to the corner
+    for (int i = m - 1; i >= 0; --i) {
+        Interval backTop;
+        for (int j = n - 1; j >= 0; --j) {
+            const FrechetCell& c = cells[i][j];
+            if (j == n - 1)
+                backTop = c.top;
+
+            Interval backRight;
+            if (i == m - 1) {
+                bool up = j == n - 1 || chain.contains(0.0);
+                backRight = up && c.right.contains(1.0) ? c.right : Interval();
+                chain = backRight;
+            } else {
+                backRight = backLeft[j];
+            }
+
+            Interval bottom, left;
+            if (!backRight.isEmpty())
+                bottom = c.bottom;
+            else if (!backTop.isEmpty() && !c.bottom.isEmpty())
+                bottom = Interval(c.bottom.start, std::min(c.bottom.end, backTop.end));
+            if (!backTop.isEmpty())
+                left = c.left;
+            else if (!backRight.isEmpty() && !c.left.isEmpty())
+                left = Interval(c.left.start, std::min(c.left.end, backRight.end));
+
+            backLeft[j] = left;
+            backTop = bottom;
+        }
+        backBottom[i] = backTop;
+    }
+
+    for (int i = 0; i < m; ++i) {
+        const Interval& b = backBottom[i];
+        if (b.isEmpty())
+            continue;
+        if (!starts_.empty() && starts_.back().end == i + b.start)
+            starts_.back() = Interval(starts_.back().start, i + b.end);
+        else
+            starts_.push_back(Interval(i + b.start, i + b.end));
+    }
+}
+
 } // namespace Frechet
@@ -5,16 +5,81 @@ namespace Frechet {
 
 class Reachability {
 public:
-    Reachability(FreeSpace& fs);
+    enum class Mode {
+        Full,          // monotone path from (0,0) to (m,n)
+        Subtrajectory  // path from anywhere on the bottom edge to anywhere on the top edge
+    };
+
+    // Q matches P[s, e] for an end e in [endStart, endEnd] (P parameters)
+    // exactly for the starts s in starts() between earliestStart and
+    // max(start, min(e, latestStart)); `start` itself reaches every end of
+    // the range. An end shared with the next match takes that match's
+    // starts, which only add to these
+    struct SubtrajectoryMatch {
+        double start;
+        double endStart;
+        double endEnd;
+        double earliestStart;
+        double latestStart;
+    };
+
+    Reachability(FreeSpace& fs, Mode mode = Mode::Full);
 
     // Initiate DP propagation
     void compute();
 
+    // Propagate into the last row (P appended) or column (Q appended) only,
+    // the rest of the diagram must already be computed (Mode::Full)
+    void extendP();
+    void extendQ();
+
+    // Propagate from the given reachable intervals on the left edges of the
+    // first column and the bottom edges of the first row, for a diagram
+    // that is one tile of a larger one
+    void computeFrom(const std::vector<Interval>& left, const std::vector<Interval>& bottom);
+
+    const std::vector<SubtrajectoryMatch>& matches() const { return matches_; }
+
+    // Mode::Subtrajectory: the starts (P parameters) from which some point
+    // of the top edge is reached, disjoint and in order, from a backward
+    // sweep. Any such start between the earliest and latest start of an
+    // end reaches it, as monotone paths that cross can swap their ends
+    const std::vector<Interval>& starts() const { return starts_; }
+
+    // reachableTop and reachableRight (with their predecessors) of one
+    // cell from its reachableLeft and reachableBottom
+    static void propagate(FrechetCell& cell);
+
 private:
     FreeSpace& fs_;
+    Mode mode_;
+    std::vector<SubtrajectoryMatch> matches_;
+    std::vector<Interval> starts_;
+
+    // Earliest and latest start reaching the points of a reachable
+    // interval, in pieces along it: from `at` (P or Q parameter) on, the
+    // earliest start is `first` and the latest max(lo, min(x, hi)) at x.
+    // Along an edge the starts only grow, so the first is non-increasing
+    // and the latest non-decreasing; the latest is x itself only for
+    // points reached straight up from the bottom edge
+    struct StartPiece {
+        double at;
+        double first;
+        double lo;
+        double hi;
+    };
+    using Starts = std::vector<StartPiece>;
+
+    void propagateCell(int i, int j);
+    // per-cell hot path, inlined into propagateCell
+    static inline Interval computeRightReachable(const FrechetCell& cell);
+    static inline Interval computeTopReachable(const FrechetCell& cell);
 
-    Interval computeRightReachable(const FrechetCell& cell);
-    Interval computeTopReachable(const FrechetCell& cell);
+    static void combine(Starts& out, const Interval& edge, double offset,
+                        const Interval& whole, double wholeOffset, const Starts& wholeStarts,
+                        const Interval& along, double alongOffset, const Starts& alongStarts);
+    void collectMatches(const std::vector<Starts>& topStarts);
+    void collectStarts();
 };
 
 } // namespace Frechet
@@ -0,0 +1,278 @@
+#include "resultcache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace Frechet {
+
+// bump when the record layout or the meaning of a stored value changes,
+// older files are ignored (4: distances are exact only)
+static const quint32 RecordVersion = 4;
+
+ResultCache& ResultCache::instance()
+{
+    static ResultCache cache;
+    return cache;
+}
+
+ResultCache::ResultCache()
+    : memory_(4096)
+{
+    QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!base.isEmpty())
+        setDirectory(base + "/frechet-results");
+}
+
+ResultCache::~ResultCache()
+{
+    flush();
+}
+
+ResultCache::Key ResultCache::key(const Polyline& P, const Polyline& Q)
+{
+    QByteArray data;
+    auto add = [&](const Polyline& c) {
+        qint64 size = c.size();
+        data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        for (const auto& p : c.vertices) {
+            double xy[2] = {p.x(), p.y()};
+            data.append(reinterpret_cast<const char*>(xy), sizeof(xy));
+        }
+    };
+    add(P);
+    add(Q);
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+}
+
+bool ResultCache::findDistance(const Key& key, double& distance)
+{
+    if (!enabled_)
+        return false;
+    QMutexLocker locker(&mutex_);
+    Record* r = record(key);
+    if (!r->hasDistance)
+        return false;
+
+    distance = r->distance;
+    return true;
+}
+
+void ResultCache::storeDistance(const Key& key, double distance)
+{
+    if (!enabled_)
+        return;
+    QMutexLocker locker(&mutex_);
+    Record* r = record(key);
+    if (r->hasDistance && r->distance == distance)
+        return;
+
+    r->hasDistance = true;
+    r->distance = distance;
+    r->decisions.clear(); // implied by the distance from now on
+    if (queue(key, *r)) {
+        locker.unlock();
+        flush();
+    }
+}
+
+bool ResultCache::findDecision(const Key& key, double eps, bool& withinEps)
+{
+    if (!enabled_)
+        return false;
+    QMutexLocker locker(&mutex_);
+    Record* r = record(key);
+    if (r->hasDistance) {
+        withinEps = r->distance <= eps;
+        return true;
+    }
+
+    auto it = r->decisions.find(eps);
+    if (it == r->decisions.end())
+        return false;
+
+    withinEps = it->second;
+    return true;
+}
+
+void ResultCache::storeDecision(const Key& key, double eps, bool withinEps)
+{
+    if (!enabled_)
+        return;
+    QMutexLocker locker(&mutex_);
+    Record* r = record(key);
+    if (r->hasDistance || r->decisions.count(eps))
+        return;
+
+    if (static_cast<int>(r->decisions.size()) >= MaxDecisions)
+        r->decisions.erase(r->decisions.begin());
+    r->decisions.emplace(eps, withinEps);
+    if (queue(key, *r)) {
+        locker.unlock();
+        flush();
+    }
+}
+
+bool ResultCache::findCriticalPath(const Key& key, std::vector<QPointF>& path)
+{
+    if (!enabled_)
+        return false;
+    QMutexLocker locker(&mutex_);
+    Record* r = record(key);
+    if (!r->hasPath)
+        return false;
+
+    path = r->path;
+    return true;
+}
+
+void ResultCache::storeCriticalPath(const Key& key, const std::vector<QPointF>& path)
+{
+    if (!enabled_)
+        return;
+    QMutexLocker locker(&mutex_);
+    Record* r = record(key);
+    if (r->hasPath && r->path == path)
+        return;
+
+    r->hasPath = true;
+    r->path = path;
+    if (queue(key, *r)) {
+        locker.unlock();
+        flush();
+    }
+}
+
+void ResultCache::flush()
+{
+    // written outside the lock, other callers go on meanwhile
+    QMutexLocker locker(&mutex_);
+    std::map<Key, Record> records;
+    records.swap(pending_);
+    QString directory = directory_;
+    locker.unlock();
+
+    if (directory.isEmpty())
+        return;
+    for (const auto& [key, record] : records)
+        save(directory, key, record);
+}
+
+bool ResultCache::queue(const Key& key, const Record& r)
+{
+    if (directory_.isEmpty())
+        return false;
+    pending_[key] = r;
+    return static_cast<int>(pending_.size()) >= MaxPending;
+}
+
+void ResultCache::setDirectory(const QString& directory)
+{
+    flush();
+
+    QMutexLocker locker(&mutex_);
+    directory_ = directory;
+    if (!directory_.isEmpty() && !QDir().mkpath(directory_))
+        directory_.clear();
+    memory_.clear();
+}
+
+void ResultCache::setMemoryCapacity(int pairs)
+{
+    QMutexLocker locker(&mutex_);
+    memory_.setMaxCost(std::max(1, pairs));
+}
+
+void ResultCache::clear()
+{
+    QMutexLocker locker(&mutex_);
+    memory_.clear();
+    pending_.clear();
+    if (!directory_.isEmpty()) {
+        QDir dir(directory_);
+        for (const QString& file : dir.entryList({"*.frc"}, QDir::Files))
+            dir.remove(file);
+    }
+}
+
+QString ResultCache::fileName(const QString& directory, const Key& key)
+{
+    return directory + "/" + QString::fromLatin1(key.toHex()) + ".frc";
+}
+
+ResultCache::Record* ResultCache::record(const Key& key)
+{
+    if (Record* r = memory_.object(key))
+        return r;
+
+    // a record evicted from memory before its write still waits here
+    auto r = new Record;
+    auto it = pending_.find(key);
+    if (it != pending_.end())
+        *r = it->second;
+    else if (!directory_.isEmpty())
+        load(key, *r);
+
+    memory_.insert(key, r);
+    return r;
+}
+
+void ResultCache::load(const Key& key, Record& record) const
+{
+    QFile file(fileName(directory_, key));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    quint32 version = 0;
+    in >> version;
+    if (version != RecordVersion)
+        return;
+
+    Record loaded;
+    quint32 decisions = 0, points = 0;
+    in >> loaded.hasDistance >> loaded.distance >> decisions;
+    for (quint32 k = 0; k < decisions && in.status() == QDataStream::Ok; ++k) {
+        double eps;
+        bool within;
+        in >> eps >> within;
+        loaded.decisions.emplace(eps, within);
+    }
+
+    in >> loaded.hasPath >> points;
+    for (quint32 p = 0; p < points && in.status() == QDataStream::Ok; ++p) {
+        QPointF pt;
+        in >> pt;
+        loaded.path.push_back(pt);
+    }
+
+    // a truncated file is treated as a miss
+    if (in.status() == QDataStream::Ok)
+        record = std::move(loaded);
+}
+
+void ResultCache::save(const QString& directory, const Key& key, const Record& record)
+{
+    // written atomically, concurrent processes never see a partial file
+    QSaveFile file(fileName(directory, key));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&file);
+    out << RecordVersion << record.hasDistance << record.distance
+        << static_cast<quint32>(record.decisions.size());
+    for (const auto& [eps, within] : record.decisions)
+        out << eps << within;
+
+    out << record.hasPath << static_cast<quint32>(record.path.size());
+    for (const auto& pt : record.path)
+        out << pt;
+
+    file.commit();
+}
+
+} // namespace Frechet
@@ -0,0 +1,89 @@
+#pragma once
+#include "Polyline.h"
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QPointF>
+#include <QString>
+#include <atomic>
+#include <map>
+#include <vector>
+
+namespace Frechet {
+
+// Results keyed by a content hash of the two vertex arrays, so repeated
+// pairs are answered without rebuilding the free space, across jobs and
+// sessions. An in-memory LRU sits in front of one small file per pair
+// under the application cache directory. Thread-safe. Stores only touch
+// memory; files are written behind, by flush().
+class ResultCache {
+public:
+    using Key = QByteArray;
+
+    static ResultCache& instance();
+
+    // SHA-256 over both vertex arrays (order matters: (P,Q) != (Q,P))
+    static Key key(const Polyline& P, const Polyline& Q);
+
+    // exact distances only, every decision is answered from them
+    bool findDistance(const Key& key, double& distance);
+    void storeDistance(const Key& key, double distance);
+
+    // a known distance answers every decision
+    bool findDecision(const Key& key, double eps, bool& withinEps);
+    void storeDecision(const Key& key, double eps, bool withinEps);
+
+    // the locally correct matching stays within d_F, so one path per pair
+    // serves every eps >= d_F
+    bool findCriticalPath(const Key& key, std::vector<QPointF>& path);
+    void storeCriticalPath(const Key& key, const std::vector<QPointF>& path);
+
+    // empty directory keeps the cache in memory only
+    void setDirectory(const QString& directory);
+    inline QString directory() const { return directory_; }
+
+    void setMemoryCapacity(int pairs);
+
+    // writes the records stored since the last flush; also runs when
+    // MaxPending records are waiting and when the cache is destroyed
+    void flush();
+
+    // when disabled every lookup misses and nothing is stored
+    inline void setEnabled(bool enabled) { enabled_ = enabled; }
+    inline bool isEnabled() const { return enabled_; }
+    void clear();
+
+    // per-pair limit, oldest thresholds are dropped first
+    static constexpr int MaxDecisions = 256;
+    // records waiting for flush() at most
+    static constexpr int MaxPending = 64;
+
+private:
+    ResultCache();
+    ~ResultCache();
+
+    struct Record {
+        bool hasDistance = false;
+        double distance = 0.0;
+        std::map<double, bool> decisions;
+        bool hasPath = false;
+        std::vector<QPointF> path;
+    };
+
+    QMutex mutex_;
+    QCache<Key, Record> memory_;
+    std::map<Key, Record> pending_; // stored since the last flush
+    QString directory_;
+    std::atomic<bool> enabled_{true};
+
+    // memory, then pending writes, then disk; creates an empty record on
+    // a miss (mutex held)
+    Record* record(const Key& key);
+    // queues r for writing, true once MaxPending records wait (mutex held)
+    bool queue(const Key& key, const Record& r);
+    void load(const Key& key, Record& record) const;
+    static void save(const QString& directory, const Key& key, const Record& record);
+    static QString fileName(const QString& directory, const Key& key);
+};
+
+} // namespace Frechet
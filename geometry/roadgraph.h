@@ -0,0 +1,18 @@
+#pragma once
+#include "Point.h"
+#include <utility>
+#include <vector>
+
+namespace Frechet {
+
+// Straight-line road network: vertices and undirected edges between them
+struct RoadGraph {
+    std::vector<Point> vertices;
+    std::vector<std::pair<int, int>> edges;
+    std::vector<std::vector<int>> incident; // edge ids per vertex, see build()
+
+    // fills `incident` after vertices and edges are set
+    void build();
+};
+
+} // namespace Frechet
@@ -0,0 +1,62 @@
+#include "robust.h"
+#include <cmath>
+
+namespace Frechet {
+
+namespace {
+
+// value = hi + lo exactly
+struct DoubleDouble {
+    double hi;
+    double lo;
+};
+
+inline DoubleDouble twoSum(double a, double b)
+{
+    double s = a + b;
+    double bb = s - a;
+    return {s, (a - (s - bb)) + (b - bb)};
+}
+
+inline DoubleDouble twoProduct(double a, double b)
+{
+    double p = a * b;
+    return {p, std::fma(a, b, -p)};
+}
+
+inline DoubleDouble add(DoubleDouble x, double y)
+{
+    DoubleDouble s = twoSum(x.hi, y);
+    return twoSum(s.hi, s.lo + x.lo);
+}
+
+// (hi + lo)^2 as a list of exact products, accumulated
+inline DoubleDouble addSquare(DoubleDouble acc, DoubleDouble v)
+{
+    DoubleDouble hh = twoProduct(v.hi, v.hi);
+    DoubleDouble hl = twoProduct(2.0 * v.hi, v.lo);
+    acc = add(acc, hh.hi);
+    acc = add(acc, hl.hi);
+    acc = add(acc, hh.lo);
+    acc = add(acc, hl.lo);
+    return add(acc, v.lo * v.lo);
+}
+
+} // namespace
+
+int compareDistanceExtended(const Point& P, const Point& C, double eps)
+{
+    DoubleDouble dx = twoSum(P.x(), -C.x());
+    DoubleDouble dy = twoSum(P.y(), -C.y());
+    DoubleDouble e2 = twoProduct(eps, eps);
+
+    DoubleDouble acc{-e2.hi, 0.0};
+    acc = add(acc, -e2.lo);
+    acc = addSquare(acc, dx);
+    acc = addSquare(acc, dy);
+
+    double value = acc.hi + acc.lo;
+    return value < 0.0 ? -1 : (value > 0.0 ? 1 : 0);
+}
+
+} // namespace Frechet
@@ -0,0 +1,95 @@
+#pragma once
+#include "FrechetCell.h"
+#include "Polyline.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Frechet {
+
+// Double-double evaluation of the sign of |P - C|^2 - eps^2
+int compareDistanceExtended(const Point& P, const Point& C, double eps);
+
+// Certified sign of |P - C|^2 - eps^2 (-1 inside the disc, 0 on its
+// boundary, 1 outside). A squared distance computed in doubles is within
+// 4 unit roundoffs of the true value and eps^2 within one, so outside
+// [lower, upper] the double comparison is already exact; only what falls
+// in between is redone in double-double arithmetic
+struct DistanceFilter {
+    double eps;
+    double e2;
+    double lower;
+    double upper;
+
+    explicit DistanceFilter(double epsilon)
+        : eps(epsilon), e2(epsilon * epsilon),
+          lower(e2 * (1.0 - 8.0 * std::numeric_limits<double>::epsilon())),
+          upper(e2 * (1.0 + 8.0 * std::numeric_limits<double>::epsilon()))
+    {
+    }
+
+    // d2: |P - C|^2 as computed in doubles
+    inline int compare(double d2, const Point& P, const Point& C) const
+    {
+        if (d2 > upper)
+            return 1;
+        if (d2 < lower)
+            return -1;
+        return compareDistanceExtended(P, C, eps);
+    }
+
+    inline int compare(const Point& P, const Point& C) const
+    {
+        double dx = P.x() - C.x();
+        double dy = P.y() - C.y();
+        return compare(dx * dx + dy * dy, P, C);
+    }
+};
+
+// { s in [0,1] : a s^2 + b s + c <= 0 } for a convex quadratic, given the
+// certified signs at the ends: s = 0 (or 1) is in the result exactly when
+// startFree (endFree) is set, whatever the rounding of the roots. disc is
+// b^2 - 4ac and root the square root of max(disc, 0), taken by the caller
+// so that many of them can be computed in one array loop
+inline Interval solveFreeInterval(double a, double b, double c, double disc, double root,
+                                  bool startFree, bool endFree)
+{
+    // both ends outside (this covers a degenerate segment, whose ends agree):
+    // free only if the minimum -b/2a lies strictly between them and dips
+    // below zero; the discriminant goes first, it rejects the far edges
+    if (!startFree && !endFree) {
+        if (disc < 0.0 || b >= 0.0 || b <= -2.0 * a)
+            return Interval();
+    } else if (startFree && endFree) {
+        // convex: both ends inside means everything in between is
+        return Interval(0.0, 1.0);
+    }
+
+    // stable roots: no cancellation between -b and the square root
+    double q = -0.5 * (b + std::copysign(root, b));
+    double r1 = q / a;
+    double r2 = q != 0.0 ? c / q : r1;
+
+    // the certified end signs win over rounded roots
+    double start = startFree ? 0.0 : std::clamp(std::min(r1, r2), std::numeric_limits<double>::denorm_min(), 1.0);
+    double end = endFree ? 1.0 : std::clamp(std::max(r1, r2), 0.0, 1.0 - std::numeric_limits<double>::epsilon() / 2.0);
+    if (startFree)
+        end = std::max(end, 0.0);
+    if (endFree)
+        start = std::min(start, 1.0);
+
+    return Interval(start, end);
+}
+
+inline Interval solveFreeInterval(double a, double b, double c, bool startFree, bool endFree)
+{
+    // the square root is only taken when the end signs leave a root to find
+    double disc = b * b - 4.0 * a * c;
+    if (!startFree && !endFree && (disc < 0.0 || b >= 0.0 || b <= -2.0 * a))
+        return Interval();
+    if (startFree && endFree)
+        return Interval(0.0, 1.0);
+    return solveFreeInterval(a, b, c, disc, std::sqrt(std::max(disc, 0.0)), startFree, endFree);
+}
+
+} // namespace Frechet
@@ -0,0 +1,159 @@
+#include "similarityjoin.h"
+#include "bounds.h"
+#include "decider.h"
+#include "workspace.h"
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+namespace Frechet {
+
+SimilarityJoin::SimilarityJoin(const std::vector<Polyline>& A, const std::vector<Polyline>& B, Options options)
+    : A_(A), B_(B), options_(options)
+{
+    options_.radius = std::max(options_.radius, 0.0);
+    options_.blockSize = std::max(options_.blockSize, 1);
+
+    for (const auto& a : A_)
+        summaryA_.push_back(summarize(a));
+    for (const auto& b : B_)
+        summaryB_.push_back(summarize(b));
+
+    // a grid of cell r, capped so cell indices stay small for tiny radii
+    double minX = 1e300, minY = 1e300, maxX = -1e300, maxY = -1e300;
+    for (const auto* set : {&summaryA_, &summaryB_}) {
+        for (const auto& s : *set) {
+            for (const Point& p : {s.start, s.end}) {
+                minX = std::min(minX, p.x());
+                minY = std::min(minY, p.y());
+                maxX = std::max(maxX, p.x());
+                maxY = std::max(maxY, p.y());
+            }
+        }
+    }
+    double diag = maxX >= minX ? std::hypot(maxX - minX, maxY - minY) : 0.0;
+    cell_ = std::max({options_.radius, diag / (1 << 20), 1e-12});
+
+    for (int b = 0; b < static_cast<int>(B_.size()); ++b) {
+        if (B_[b].vertices.empty())
+            continue;
+        const Summary& s = summaryB_[b];
+        grid_.emplace_back(bucket(cellOf(s.start.x()), cellOf(s.start.y()),
+                                  cellOf(s.end.x()), cellOf(s.end.y())), b);
+    }
+    std::sort(grid_.begin(), grid_.end());
+}
+
+SimilarityJoin::Summary SimilarityJoin::summarize(const Polyline& curve)
+{
+    Summary s{Point(), Point(), 1e300, 1e300, -1e300, -1e300};
+    if (curve.vertices.empty())
+        return s;
+
+    s.start = curve.vertices.front();
+    s.end = curve.vertices.back();
+    for (const auto& v : curve.vertices) {
+        s.minX = std::min(s.minX, v.x());
+        s.minY = std::min(s.minY, v.y());
+        s.maxX = std::max(s.maxX, v.x());
+        s.maxY = std::max(s.maxY, v.y());
+    }
+    return s;
+}
+
+bool SimilarityJoin::mayMatch(const Summary& a, const Summary& b) const
+{
+    double r = options_.radius;
+    if (pointDistance(a.start, b.start) > r || pointDistance(a.end, b.end) > r)
+        return false;
+
+    // every point of one curve is within r of the other (Hausdorff <= d_F)
+    return a.minX >= b.minX - r && a.maxX <= b.maxX + r && a.minY >= b.minY - r && a.maxY <= b.maxY + r
+        && b.minX >= a.minX - r && b.maxX <= a.maxX + r && b.minY >= a.minY - r && b.maxY <= a.maxY + r;
+}
+
+long long SimilarityJoin::cellOf(double v) const
+{
+    return static_cast<long long>(std::floor(v / cell_));
+}
+
+unsigned long long SimilarityJoin::bucket(long long sx, long long sy, long long ex, long long ey)
+{
+    // collisions only add candidates, the filters drop them again
+    unsigned long long h = 0x84222325cbf29ce4ULL;
+    for (long long v : {sx, sy, ex, ey}) {
+        h ^= static_cast<unsigned long long>(v) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h *= 0xbf58476d1ce4e5b9ULL;
+    }
+    return h;
+}
+
+void SimilarityJoin::candidates(int a, std::vector<int>& out) const
+{
+    out.clear();
+    if (A_[a].vertices.empty())
+        return;
+
+    // endpoints within r lie in the same or a neighbouring cell
+    const Summary& s = summaryA_[a];
+    long long sx = cellOf(s.start.x()), sy = cellOf(s.start.y());
+    long long ex = cellOf(s.end.x()), ey = cellOf(s.end.y());
+    for (int k = 0; k < 81; ++k) {
+        unsigned long long key = bucket(sx + k % 3 - 1, sy + k / 3 % 3 - 1,
+                                        ex + k / 9 % 3 - 1, ey + k / 27 - 1);
+        auto it = std::lower_bound(grid_.begin(), grid_.end(), std::make_pair(key, -1));
+        for (; it != grid_.end() && it->first == key; ++it)
+            out.push_back(it->second);
+    }
+
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+SimilarityJoin::Stats SimilarityJoin::run(const std::function<void(int a, int b)>& sink)
+{
+    struct Pair {
+        int a;
+        int b;
+        char within;
+    };
+
+    Stats stats;
+    std::vector<int> ids;
+    std::vector<Pair> pairs;
+    int n = static_cast<int>(A_.size());
+
+    for (int first = 0; first < n; first += options_.blockSize) {
+        int last = std::min(n, first + options_.blockSize);
+
+        pairs.clear();
+        for (int a = first; a < last; ++a) {
+            candidates(a, ids);
+            stats.candidates += static_cast<long long>(ids.size());
+            for (int b : ids)
+                if (mayMatch(summaryA_[a], summaryB_[b]))
+                    pairs.push_back({a, b, 0});
+        }
+        stats.verified += static_cast<long long>(pairs.size());
+
+        auto verify = [&](Pair& p) {
+            // one-off pairs, keep them out of the result cache
+            thread_local Workspace workspace;
+            Decider decider(A_[p.a], B_[p.b], &workspace);
+            decider.setCacheEnabled(false);
+            p.within = decider.decide(options_.radius).withinEps;
+        };
+        QtConcurrent::blockingMap(pairs, verify);
+
+        for (const Pair& p : pairs) {
+            if (p.within) {
+                ++stats.matches;
+                sink(p.a, p.b);
+            }
+        }
+    }
+
+    return stats;
+}
+
+} // namespace Frechet
@@ -0,0 +1,60 @@
+#pragma once
+#include "Polyline.h"
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Frechet {
+
+// Threshold similarity join: every pair (a in A, b in B) with
+// d_F(a, b) <= r. Matched curves start and end within r of each other,
+// so B is bucketed on a grid of cell r over its (start, end) points and a
+// curve of A only meets the B curves of the 3^4 neighbouring buckets.
+// Those candidates are filtered in O(1) by the endpoint distances and the
+// bounding boxes (each must lie in the other grown by r), and the rest
+// are verified with the Decider on the thread pool, a block of A at a
+// time, so results stream out while memory stays bounded.
+class SimilarityJoin {
+public:
+    struct Options {
+        double radius = 1.0;
+        int blockSize = 1024; // curves of A per verification round
+    };
+
+    struct Stats {
+        long long candidates = 0; // from the grid buckets
+        long long verified = 0;   // passed the O(1) filters
+        long long matches = 0;
+    };
+
+    // the sets must outlive the join
+    SimilarityJoin(const std::vector<Polyline>& A, const std::vector<Polyline>& B, Options options);
+
+    // calls sink(a, b) for every pair within the radius, ordered by a,
+    // then b, from the calling thread
+    Stats run(const std::function<void(int a, int b)>& sink);
+
+private:
+    struct Summary {
+        Point start;
+        Point end;
+        double minX, minY, maxX, maxY;
+    };
+
+    const std::vector<Polyline>& A_;
+    const std::vector<Polyline>& B_;
+    Options options_;
+
+    std::vector<Summary> summaryA_;
+    std::vector<Summary> summaryB_;
+    double cell_ = 1.0;
+    std::vector<std::pair<unsigned long long, int>> grid_; // (bucket key, B id), sorted
+
+    static Summary summarize(const Polyline& curve);
+    bool mayMatch(const Summary& a, const Summary& b) const;
+    long long cellOf(double v) const;
+    static unsigned long long bucket(long long sx, long long sy, long long ex, long long ey);
+    void candidates(int a, std::vector<int>& out) const;
+};
+
+} // namespace Frechet
@@ -0,0 +1,79 @@
+#include "simplification.h"
+#include "freespace.h"
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace Frechet {
+
+bool shortcutWithin(const Polyline& P, int i, int j, double eps)
+{
+    const Point& a = P.vertices[i];
+    const Point& b = P.vertices[j];
+
+    // furthest position on the shortcut reached so far
+    double pos = 0.0;
+    for (int k = i; k <= j; ++k) {
+        Interval I = segmentPointInterval(a, b, P.vertices[k], eps);
+        if (I.isEmpty())
+            return false;
+
+        pos = std::max(pos, I.start);
+        if (pos > I.end)
+            return false;
+    }
+
+    return true;
+}
+
+Polyline simplifyFrechet(const Polyline& P, double eps)
+{
+    int n = P.size();
+    if (n <= 2)
+        return P;
+
+    Polyline result;
+    result.vertices.push_back(P.vertices.front());
+
+    int i = 0;
+    while (i < n - 1) {
+        // i -> i+1 always works; double the step while the shortcut holds
+        int good = i + 1;
+        int step = 2;
+        int bad = n;
+        while (i + step < n) {
+            if (!shortcutWithin(P, i, i + step, eps)) {
+                bad = i + step;
+                break;
+            }
+            good = i + step;
+            step *= 2;
+        }
+        if (bad == n && good < n - 1) {
+            if (shortcutWithin(P, i, n - 1, eps))
+                good = n - 1;
+            else
+                bad = n - 1;
+        }
+
+        while (bad - good > 1) {
+            int mid = (good + bad) / 2;
+            if (shortcutWithin(P, i, mid, eps))
+                good = mid;
+            else
+                bad = mid;
+        }
+
+        result.vertices.push_back(P.vertices[good]);
+        i = good;
+    }
+
+    return result;
+}
+
+std::vector<Polyline> simplifyFrechet(const std::vector<Polyline>& curves, double eps)
+{
+    return QtConcurrent::blockingMapped<std::vector<Polyline>>(
+        curves, [eps](const Polyline& c) { return simplifyFrechet(c, eps); });
+}
+
+} // namespace Frechet
@@ -0,0 +1,20 @@
+#pragma once
+#include "Polyline.h"
+#include <vector>
+
+namespace Frechet {
+
+// Is the shortcut P[i]P[j] within Frechet distance eps of P[i..j]?
+// Exact: every vertex must map onto the shortcut monotonically, and
+// edges in between follow by convexity, O(j - i).
+bool shortcutWithin(const Polyline& P, int i, int j, double eps);
+
+// Greedy vertex-restricted simplification with d_F(P, result) <= eps.
+// The next shortcut is found by exponential then binary search, so a
+// curve of n vertices takes O(n log n) shortcut tests.
+Polyline simplifyFrechet(const Polyline& P, double eps);
+
+// All curves in parallel
+std::vector<Polyline> simplifyFrechet(const std::vector<Polyline>& curves, double eps);
+
+} // namespace Frechet
@@ -0,0 +1,118 @@
+#include "slidingwindow.h"
+#include "reachability.h"
+#include <algorithm>
+
+namespace Frechet {
+
+static bool sameInterval(const Interval& a, const Interval& b)
+{
+    return a.isEmpty() == b.isEmpty() && a.start == b.start && a.end == b.end;
+}
+
+SlidingWindowMonitor::SlidingWindowMonitor(const Polyline& reference,
+                                           int windowSize,
+                                           double threshold)
+    : reference_(makePolyline(reference))
+    , windowSize_(std::max(2, windowSize))
+    , threshold_(threshold)
+    , points_(windowSize_)
+    , columns_(windowSize_)
+    , column_(makePolyline(), reference_, threshold_)
+{
+}
+
+bool SlidingWindowMonitor::push(const Point& p)
+{
+    if (count_ == windowSize_) {
+        // the oldest point and its column expire, the new point takes the slot
+        head_ = (head_ + 1) % windowSize_;
+        --count_;
+    }
+
+    points_[slot(count_)] = p;
+    ++count_;
+
+    if (count_ >= 2) {
+        Polyline segment;
+        segment.vertices = {points_[slot(count_ - 2)], p};
+        column_.reset(makePolyline(std::move(segment)), reference_, threshold_);
+        std::swap(columns_[slot(count_ - 2)], column_.getCells()[0]);
+        fresh_ = std::min(fresh_ + 1, count_ - 1);
+    }
+
+    bool within = evaluate();
+    if (within != within_ && onCrossing)
+        onCrossing(within);
+    within_ = within;
+    return within_;
+}
+
+bool SlidingWindowMonitor::enter(int k)
+{
+    // sets the reachable intervals entering column k from the left and
+    // below, returns whether they changed
+    auto& column = columns_[slot(k)];
+    int n = static_cast<int>(column.size());
+    bool changed = false;
+    auto set = [&](Interval& stored, const Interval& value) {
+        if (!sameInterval(stored, value)) {
+            stored = value;
+            changed = true;
+        }
+    };
+
+    if (k == 0) {
+        // the window start: the left border is reachable as far as it is
+        // free without a gap from the origin, as in Reachability::compute
+        for (int j = 0; j < n; ++j) {
+            bool from = j == 0 || column[j-1].reachableLeft.contains(1.0);
+            set(column[j].reachableLeft, from && column[j].left.contains(0.0) ? column[j].left : Interval());
+        }
+        set(column[0].reachableBottom, column[0].bottom.contains(0.0) ? column[0].bottom : Interval());
+    } else {
+        const auto& previous = columns_[slot(k - 1)];
+        for (int j = 0; j < n; ++j)
+            set(column[j].reachableLeft, previous[j].reachableRight);
+        bool from = previous[0].reachableBottom.contains(1.0);
+        set(column[0].reachableBottom, from && column[0].bottom.contains(0.0) ? column[0].bottom : Interval());
+    }
+    return changed;
+}
+
+bool SlidingWindowMonitor::evaluate()
+{
+    if (count_ < 2 || reference_->size() < 2)
+        return false;
+
+    // cheap lower bound first: the window endpoints must be matched
+    // to the reference endpoints
+    int columns = count_ - 1;
+    const FrechetCell& firstCell = columns_[slot(0)].front();
+    const FrechetCell& lastCell = columns_[slot(columns - 1)].back();
+    if (!firstCell.bottom.contains(0.0) || !lastCell.top.contains(1.0))
+        return false;
+
+    // columns before the fresh ones were propagated from what they hold;
+    // one entered as before leaves everything up to the fresh ones as is
+    int stale = columns - fresh_;
+    for (int k = 0; k < columns; ++k) {
+        if (!enter(k) && k < stale) {
+            k = stale - 1;
+            continue;
+        }
+
+        auto& column = columns_[slot(k)];
+        int n = static_cast<int>(column.size());
+        for (int j = 0; j < n; ++j) {
+            Reachability::propagate(column[j]);
+            if (j + 1 < n)
+                column[j+1].reachableBottom = column[j].reachableTop;
+        }
+    }
+    fresh_ = 0;
+
+    const FrechetCell& c = columns_[slot(columns - 1)].back();
+    return c.reachableTop.contains(1.0) || c.reachableRight.contains(1.0);
+}
+
+} // namespace Frechet
@@ -0,0 +1,50 @@
+#pragma once
+#include "freespace.h"
+#include <functional>
+#include <vector>
+
+namespace Frechet {
+
+// Compares the last W points of a live stream against a fixed reference
+// curve. Points and free space columns (one window segment against the
+// whole reference) live in fixed rings indexed from a head offset, so a
+// slide computes one new column and drops the oldest without moving
+// anything. Reachability is re-propagated from the new start only until
+// a column is entered exactly as before; from there on the window's
+// reachability is unchanged and only the new column is propagated.
+class SlidingWindowMonitor {
+public:
+    SlidingWindowMonitor(const Polyline& reference, int windowSize, double threshold);
+
+    // Feed the next stream point, returns whether the window is within threshold
+    bool push(const Point& p);
+
+    inline bool isWithin() const { return within_; }
+    inline int windowSize() const { return windowSize_; }
+    inline double threshold() const { return threshold_; }
+
+    // Called whenever the window's distance crosses the threshold
+    std::function<void(bool within)> onCrossing;
+
+private:
+    PolylinePtr reference_;
+    int windowSize_;
+    double threshold_;
+
+    // point k of the window and column k (points k, k+1) are in slot
+    // (head_ + k) % windowSize_; the newest point's column slot is unused
+    std::vector<Point> points_;
+    std::vector<std::vector<FrechetCell>> columns_;
+    int head_ = 0;
+    int count_ = 0;
+    int fresh_ = 0; // newest columns not propagated yet
+    bool within_ = false;
+
+    FreeSpace column_; // computes one new column of cells
+
+    inline int slot(int k) const { return (head_ + k) % windowSize_; }
+    bool enter(int k);
+    bool evaluate();
+};
+
+} // namespace Frechet
@@ -0,0 +1,242 @@
+#include "tiledfreespace.h"
+#include "reachability.h"
+#include <QDebug>
+#include <QDir>
+#include <algorithm>
+
+namespace Frechet {
+
+static int tilesFor(int cells, int tileSize)
+{
+    return (cells + tileSize - 1) / tileSize;
+}
+
+TiledFreeSpace::TiledFreeSpace(const Polyline& P, const Polyline& Q, double eps, int tileSize)
+    : P_(P), Q_(Q), eps_(eps)
+{
+    m_ = std::max(P.size() - 1, 0);
+    n_ = std::max(Q.size() - 1, 0);
+    tile_ = std::max(tileSize, 1);
+    tilesX_ = tilesFor(m_, tile_);
+    tilesY_ = tilesFor(n_, tile_);
+}
+
+void TiledFreeSpace::setScratchDirectory(const QString& directory)
+{
+    directory_ = directory;
+}
+
+qint64 TiledFreeSpace::scratchBytes(int m, int n, int tileSize)
+{
+    tileSize = std::max(tileSize, 1);
+    qint64 tiles = static_cast<qint64>(tilesFor(m, tileSize)) * tilesFor(n, tileSize);
+    return tiles * 2 * tileSize * static_cast<qint64>(sizeof(Bound));
+}
+
+bool TiledFreeSpace::openScratch()
+{
+    if (bounds_)
+        return true;
+
+    QString dir = directory_.isEmpty() ? QDir::tempPath() : directory_;
+    file_.setFileTemplate(dir + "/frechet-tiles-XXXXXX");
+
+    // the file stays sparse: only tiles that something enters are written
+    qint64 bytes = scratchBytes(m_, n_, tile_);
+    if (!file_.open() || !file_.resize(bytes)) {
+        qWarning() << "Cannot create scratch file in" << dir << file_.errorString();
+        return false;
+    }
+
+    bounds_ = reinterpret_cast<Bound*>(file_.map(0, bytes));
+    if (!bounds_) {
+        qWarning() << "Cannot map" << bytes << "bytes of" << file_.fileName() << file_.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool TiledFreeSpace::compute()
+{
+    reachable_ = false;
+    if (m_ == 0 || n_ == 0)
+        return true;
+    if (!openScratch())
+        return false;
+
+    live_.assign(static_cast<size_t>(tilesX_) * tilesY_, 0);
+    leftChain_.assign(tilesY_ + 1, 0);
+    bottomChain_.assign(tilesX_ + 1, 0);
+    leftChain_[0] = bottomChain_[0] = 1; // the origin
+
+    // tile rows bottom up, so the file is written front to back
+    for (int ty = 0; ty < tilesY_; ++ty) {
+        for (int tx = 0; tx < tilesX_; ++tx) {
+            FreeSpace* fs = loadTile(tx, ty, true);
+            if (!fs)
+                continue;
+
+            const auto& cells = fs->getCells();
+            int w = fs->getM();
+            int h = fs->getN();
+
+            Bound* r = right(tx, ty);
+            for (int j = 0; j < h; ++j) {
+                const Interval& e = cells[w-1][j].reachableRight;
+                r[j] = e.isEmpty() ? Bound{1.0, 0.0} : Bound{e.start, e.end};
+            }
+            Bound* t = top(tx, ty);
+            for (int i = 0; i < w; ++i) {
+                const Interval& e = cells[i][h-1].reachableTop;
+                t[i] = e.isEmpty() ? Bound{1.0, 0.0} : Bound{e.start, e.end};
+            }
+        }
+    }
+
+    int tx = tilesX_ - 1;
+    int ty = tilesY_ - 1;
+    if (live_[static_cast<size_t>(ty) * tilesX_ + tx]) {
+        const Bound& r = right(tx, ty)[(n_ - 1) % tile_];
+        const Bound& t = top(tx, ty)[(m_ - 1) % tile_];
+        reachable_ = (r.start <= 1.0 && 1.0 <= r.end) || (t.start <= 1.0 && 1.0 <= t.end);
+    }
+    return true;
+}
+
+FreeSpace* TiledFreeSpace::loadTile(int tx, int ty, bool forward)
+{
+    int i0 = tx * tile_;
+    int j0 = ty * tile_;
+    int w = std::min(tile_, m_ - i0);
+    int h = std::min(tile_, n_ - j0);
+
+    // reachable intervals entering from the left and lower neighbours
+    bool any = false;
+    left_.assign(h, Interval());
+    bottom_.assign(w, Interval());
+    if (tx > 0 && live_[static_cast<size_t>(ty) * tilesX_ + tx - 1]) {
+        const Bound* r = right(tx - 1, ty);
+        for (int j = 0; j < h; ++j) {
+            left_[j] = Interval(r[j].start, r[j].end);
+            any = any || !left_[j].isEmpty();
+        }
+    }
+    if (ty > 0 && live_[static_cast<size_t>(ty - 1) * tilesX_ + tx]) {
+        const Bound* t = top(tx, ty - 1);
+        for (int i = 0; i < w; ++i) {
+            bottom_[i] = Interval(t[i].start, t[i].end);
+            any = any || !bottom_[i].isEmpty();
+        }
+    }
+
+    bool chainLeft = tx == 0 && leftChain_[ty];
+    bool chainBottom = ty == 0 && bottomChain_[tx];
+    if (!any && !chainLeft && !chainBottom)
+        return nullptr;
+
+    subP_.vertices.assign(P_.vertices.begin() + i0, P_.vertices.begin() + i0 + w + 1);
+    subQ_.vertices.assign(Q_.vertices.begin() + j0, Q_.vertices.begin() + j0 + h + 1);
+    FreeSpace& fs = workspace_.freeSpace(subP_, subQ_, eps_);
+    const auto& cells = fs.getCells();
+
+    // the borders of the diagram are reachable as far as they are free
+    // without a gap from the origin, as in Reachability::compute
+    if (chainLeft) {
+        for (int j = 0; j < h; ++j) {
+            bool from = j == 0 || left_[j-1].contains(1.0);
+            left_[j] = from && cells[0][j].left.contains(0.0) ? cells[0][j].left : Interval();
+        }
+    }
+    if (chainBottom) {
+        for (int i = 0; i < w; ++i) {
+            bool from = i == 0 || bottom_[i-1].contains(1.0);
+            bottom_[i] = from && cells[i][0].bottom.contains(0.0) ? cells[i][0].bottom : Interval();
+        }
+    }
+
+    if (forward) {
+        live_[static_cast<size_t>(ty) * tilesX_ + tx] = 1;
+        if (chainLeft)
+            leftChain_[ty + 1] = left_[h-1].contains(1.0);
+        if (chainBottom)
+            bottomChain_[tx + 1] = bottom_[w-1].contains(1.0);
+    }
+
+    Reachability(fs).computeFrom(left_, bottom_);
+    return &fs;
+}
+
+std::vector<QPointF> TiledFreeSpace::computeCriticalPath()
+{
+    std::vector<QPointF> path;
+    computeCriticalPath(path);
+    return path;
+}
+
+void TiledFreeSpace::computeCriticalPath(std::vector<QPointF>& path)
+{
+    path.clear();
+    if (!reachable_)
+        return;
+
+    // walk back from (m,n), one point per cell edge crossed; (x,y) is the
+    // current point inside cell (ci,cj) of tile (tx,ty)
+    int tx = tilesX_ - 1;
+    int ty = tilesY_ - 1;
+    int ci = (m_ - 1) % tile_;
+    int cj = (n_ - 1) % tile_;
+    double x = 1.0;
+    double y = 1.0;
+    path.emplace_back(m_, n_);
+
+    for (;;) {
+        FreeSpace* fs = loadTile(tx, ty, false);
+        const auto& cells = fs->getCells();
+        int i0 = tx * tile_;
+        int j0 = ty * tile_;
+
+        while (ci >= 0 && cj >= 0) {
+            // free space is convex within a cell, so any reachable point
+            // below and left of (x,y) on the left or bottom edge leads to it
+            const FrechetCell& c = cells[ci][cj];
+            bool fromLeft = !c.reachableLeft.isEmpty() && c.reachableLeft.start <= y;
+            if (fromLeft) {
+                x = 0.0;
+                y = std::min(y, c.reachableLeft.end);
+            } else {
+                x = std::min(x, c.reachableBottom.end);
+                y = 0.0;
+            }
+
+            double px = i0 + ci + x;
+            double py = j0 + cj + y;
+            path.emplace_back(px, py);
+
+            // the borders of the diagram are free down to the origin
+            if (px == 0.0 || py == 0.0) {
+                if (px != 0.0 || py != 0.0)
+                    path.emplace_back(0.0, 0.0);
+                std::reverse(path.begin(), path.end());
+                return;
+            }
+
+            if (fromLeft) {
+                --ci;
+                x = 1.0;
+            } else {
+                --cj;
+                y = 1.0;
+            }
+        }
+
+        if (ci < 0) {
+            --tx;
+            ci = tile_ - 1;
+        } else {
+            --ty;
+            cj = tile_ - 1;
+        }
+    }
+}
+
+} // namespace Frechet
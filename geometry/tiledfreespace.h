@@ -0,0 +1,89 @@
+#pragma once
+#include "FrechetCell.h"
+#include "Polyline.h"
+#include "workspace.h"
+#include <QPointF>
+#include <QString>
+#include <QTemporaryFile>
+#include <vector>
+
+namespace Frechet {
+
+// Free space of pairs too large for FreeSpace's cell matrix (10^5 x 10^5
+// cells and up). The diagram is cut into square tiles of cells, and only
+// the reachable intervals on the right and top border of every tile are
+// kept, in a memory-mapped scratch file written tile after tile. A tile
+// is rebuilt in memory from the borders of its left and lower neighbours
+// when needed, so the path is recovered by revisiting only the tiles it
+// passes. Tiles no reachable interval enters are skipped and never touch
+// the file.
+class TiledFreeSpace {
+public:
+    static constexpr int DefaultTileSize = 256;
+
+    TiledFreeSpace(const Polyline& P, const Polyline& Q, double eps, int tileSize = DefaultTileSize);
+
+    // scratch file location, the system temp directory by default
+    void setScratchDirectory(const QString& directory);
+
+    // Reachability, tile by tile; false (with a warning) if the scratch
+    // file cannot be created or mapped
+    bool compute();
+
+    inline int getM() const { return m_; }
+    inline int getN() const { return n_; }
+    inline double getEps() const { return eps_; }
+    inline int tileSize() const { return tile_; }
+
+    bool isTopRightReachable() const { return reachable_; }
+
+    // Monotone path through the free space from (0,0) to (m,n), P along x,
+    // empty if (m,n) is not reachable. Any path within eps, not the locally
+    // correct one of FreeSpace
+    std::vector<QPointF> computeCriticalPath();
+    void computeCriticalPath(std::vector<QPointF>& path);
+
+    // size of the scratch file for m x n cells
+    static qint64 scratchBytes(int m, int n, int tileSize = DefaultTileSize);
+
+private:
+    // reachable interval on a border, empty when start > end
+    struct Bound {
+        double start;
+        double end;
+    };
+
+    const Polyline& P_;
+    const Polyline& Q_;
+    double eps_;
+    int m_;
+    int n_;
+    int tile_;
+    int tilesX_;
+    int tilesY_;
+    bool reachable_ = false;
+
+    QString directory_;
+    QTemporaryFile file_;
+    Bound* bounds_ = nullptr; // per tile: right border, then top border
+
+    std::vector<char> live_;        // a reachable interval enters the tile
+    std::vector<char> leftChain_;   // per tile row: x = 0 is reachable up to it
+    std::vector<char> bottomChain_; // per tile column: y = 0 is reachable up to it
+
+    // tile being rebuilt
+    Workspace workspace_;
+    Polyline subP_;
+    Polyline subQ_;
+    std::vector<Interval> left_;
+    std::vector<Interval> bottom_;
+
+    bool openScratch();
+    inline Bound* right(int tx, int ty) const { return bounds_ + 2LL * tile_ * (static_cast<qint64>(ty) * tilesX_ + tx); }
+    inline Bound* top(int tx, int ty) const { return right(tx, ty) + tile_; }
+
+    // the tile's cells with reachability, null if nothing enters it
+    FreeSpace* loadTile(int tx, int ty, bool forward);
+};
+
+} // namespace Frechet
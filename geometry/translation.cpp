@@ -0,0 +1,151 @@
+#include "translation.h"
+#include "bounds.h"
+#include "decider.h"
+#include "freespace.h"
+#include "workspace.h"
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+namespace Frechet {
+
+// d_F(P, Q + t) bracketed to relative width `tolerance`
+struct Bracket {
+    double lo;
+    double hi;
+};
+
+static Bracket bracketDistance(const Polyline& P, const Polyline& Q, double tolerance, Workspace& ws)
+{
+    Decider decider(P, Q, &ws);
+    decider.setCacheEnabled(false);
+
+    double lo = decider.lowerBound();
+    double hi = decider.upperBound();
+    while (hi - lo > tolerance * std::max(hi, 1e-12)) {
+        double mid = 0.5 * (lo + hi);
+        if (decider.decide(mid).withinEps)
+            hi = mid;
+        else
+            lo = mid;
+    }
+    return {lo, hi};
+}
+
+// smallest distance from the box to a point
+static double boxDistance(const QPointF& center, double half, const QPointF& p)
+{
+    double dx = std::max(std::abs(p.x() - center.x()) - half, 0.0);
+    double dy = std::max(std::abs(p.y() - center.y()) - half, 0.0);
+    return std::hypot(dx, dy);
+}
+
+TranslationFrechet::TranslationFrechet(const Polyline& P, const Polyline& Q)
+    : P_(P), Q_(Q)
+{
+}
+
+Polyline TranslationFrechet::translated(const Polyline& curve, const QPointF& t)
+{
+    Polyline result = curve;
+    for (auto& v : result.vertices)
+        v += t;
+    return result;
+}
+
+TranslationFrechet::Result TranslationFrechet::solve(double delta)
+{
+    Result result;
+    if (P_.size() == 0 || Q_.size() == 0)
+        return result;
+
+    delta = std::max(delta, 1e-6);
+
+    // the start and end points alone pin t near these offsets
+    QPointF a = P_.vertices.front() - Q_.vertices.front();
+    QPointF b = P_.vertices.back() - Q_.vertices.back();
+
+    Workspace ws;
+    result.translation = (a + b) / 2.0;
+    double best = bracketDistance(P_, translated(Q_, result.translation), delta / 4.0, ws).hi;
+    ++result.evaluations;
+
+    // every t with d_F <= best lies within best of a
+    std::vector<Box> level = {{a, best}};
+    double minHalf = 1e-9 * std::max(1.0, best);
+
+    struct Outcome {
+        bool evaluated = false;
+        bool split = false;
+        double hi = 0.0;
+    };
+
+    while (!level.empty()) {
+        result.boxes += static_cast<int>(level.size());
+        double target = best / (1.0 + delta);
+
+        std::vector<Outcome> outcomes(level.size());
+        std::vector<int> indices(level.size());
+        for (size_t k = 0; k < level.size(); ++k)
+            indices[k] = static_cast<int>(k);
+
+        auto evaluate = [&](int k) {
+            const Box& box = level[k];
+            Outcome& out = outcomes[k];
+            double r = box.half * std::sqrt(2.0);
+
+            if (std::max(boxDistance(box.center, box.half, a),
+                         boxDistance(box.center, box.half, b)) >= target)
+                return;
+
+            thread_local Workspace local;
+            Polyline moved = translated(Q_, box.center);
+
+            // one decision rules out the whole box before any bisection
+            Decider decider(P_, moved, &local);
+            decider.setCacheEnabled(false);
+            if (!decider.decide(target + r).withinEps)
+                return;
+
+            Bracket d = bracketDistance(P_, moved, delta / 4.0, local);
+            out.evaluated = true;
+            out.hi = d.hi;
+            out.split = d.lo - r < target && box.half > minHalf;
+        };
+        QtConcurrent::blockingMap(indices, evaluate);
+
+        std::vector<Box> next;
+        for (size_t k = 0; k < level.size(); ++k) {
+            const Outcome& out = outcomes[k];
+            if (!out.evaluated)
+                continue;
+
+            ++result.evaluations;
+            if (out.hi < best) {
+                best = out.hi;
+                result.translation = level[k].center;
+            }
+
+            if (out.split) {
+                double h = level[k].half / 2.0;
+                const QPointF& c = level[k].center;
+                next.push_back({c + QPointF(-h, -h), h});
+                next.push_back({c + QPointF(h, -h), h});
+                next.push_back({c + QPointF(-h, h), h});
+                next.push_back({c + QPointF(h, h), h});
+            }
+        }
+        level = std::move(next);
+    }
+
+    result.distance = best;
+
+    FreeSpace fs(P_, translated(Q_, result.translation), best * (1.0 + 1e-9));
+    fs.computeReachability();
+    if (fs.isTopRightReachable())
+        fs.computeCriticalPath(result.matching);
+
+    return result;
+}
+
+} // namespace Frechet
@@ -0,0 +1,39 @@
+#pragma once
+#include "Polyline.h"
+#include <QPointF>
+#include <vector>
+
+namespace Frechet {
+
+// min over t of d_F(P, Q + t), by branch-and-bound over translation boxes.
+// d_F(P, Q + t) is 1-Lipschitz in t, so a box with center c and
+// half-diagonal r cannot beat d_F(P, Q + c) - r; boxes are also pruned
+// by the endpoint bound and by a single decider call before any
+// distance is computed. Each level of boxes is evaluated in parallel.
+class TranslationFrechet {
+public:
+    struct Result {
+        QPointF translation;          // applied to Q
+        double distance = 0.0;        // within (1 + delta) of the optimum
+        std::vector<QPointF> matching; // critical path of (P, Q + translation)
+        int boxes = 0;                // boxes examined
+        int evaluations = 0;          // boxes that needed a distance
+    };
+
+    TranslationFrechet(const Polyline& P, const Polyline& Q);
+
+    Result solve(double delta = 0.01);
+
+    static Polyline translated(const Polyline& curve, const QPointF& t);
+
+private:
+    const Polyline& P_;
+    const Polyline& Q_;
+
+    struct Box {
+        QPointF center;
+        double half; // half side length
+    };
+};
+
+} // namespace Frechet
@@ -0,0 +1,108 @@
+#include "weakfrechet.h"
+#include "bounds.h"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace Frechet {
+
+namespace {
+
+struct UnionFind {
+    std::vector<int> parent;
+    std::vector<int> size;
+
+    explicit UnionFind(int count) : parent(count), size(count, 1)
+    {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+
+    int find(int x)
+    {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void unite(int a, int b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return;
+        if (size[a] < size[b])
+            std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+    }
+};
+
+struct CellEdge {
+    double eps;
+    int a;
+    int b;
+};
+
+} // namespace
+
+double weakFrechetDistance(const Polyline& P, const Polyline& Q)
+{
+    if (P.size() == 0 || Q.size() == 0)
+        return 0.0;
+
+    // a single point is matched to the whole other curve
+    if (P.size() == 1 || Q.size() == 1) {
+        const Polyline& point = P.size() == 1 ? P : Q;
+        const Polyline& curve = P.size() == 1 ? Q : P;
+        double d = 0.0;
+        for (const auto& v : curve.vertices)
+            d = std::max(d, pointDistance(point.vertices[0], v));
+        return d;
+    }
+
+    int m = P.size() - 1;
+    int n = Q.size() - 1;
+    const auto& p = P.vertices;
+    const auto& q = Q.vertices;
+
+    double endpoints = endpointLowerBound(P, Q);
+    if (m == 1 && n == 1)
+        return endpoints;
+
+    auto cell = [n](int i, int j) { return i * n + j; };
+
+    std::vector<CellEdge> edges;
+    edges.reserve(static_cast<size_t>(m) * n * 2);
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            // right edge: Q segment j against P[i+1]
+            if (i + 1 < m)
+                edges.push_back({pointSegmentDistance(p[i + 1], q[j], q[j + 1]), cell(i, j), cell(i + 1, j)});
+            // top edge: P segment i against Q[j+1]
+            if (j + 1 < n)
+                edges.push_back({pointSegmentDistance(q[j + 1], p[i], p[i + 1]), cell(i, j), cell(i, j + 1)});
+        }
+    }
+
+    std::sort(edges.begin(), edges.end(),
+              [](const CellEdge& x, const CellEdge& y) { return x.eps < y.eps; });
+
+    UnionFind components(m * n);
+    int first = cell(0, 0);
+    int last = cell(m - 1, n - 1);
+    double bottleneck = 0.0;
+
+    for (const auto& e : edges) {
+        components.unite(e.a, e.b);
+        if (components.find(first) == components.find(last)) {
+            bottleneck = e.eps;
+            break;
+        }
+    }
+
+    return std::max(endpoints, bottleneck);
+}
+
+} // namespace Frechet
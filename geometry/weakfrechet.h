@@ -0,0 +1,15 @@
+#pragma once
+#include "Polyline.h"
+
+namespace Frechet {
+
+// Weak Frechet distance: like d_F but the matching need not be monotone.
+// Two neighbouring cells of the free space connect once their shared
+// edge has a free point, i.e. at the distance between that edge's
+// vertex and segment; the answer is the bottleneck of a path from the
+// first to the last cell, found exactly by union-find over the edges in
+// order of that value, O(mn log mn).
+// Never larger than d_F, so it also serves as a pruning lower bound.
+double weakFrechetDistance(const Polyline& P, const Polyline& Q);
+
+} // namespace Frechet
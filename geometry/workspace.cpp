@@ -0,0 +1,30 @@
+#include "workspace.h"
+
+namespace Frechet {
+
+FreeSpace& Workspace::freeSpace(const Polyline& P, const Polyline& Q, double eps)
+{
+    if (fs_)
+        fs_->reset(P, Q, eps);
+    else
+        fs_ = std::make_unique<FreeSpace>(P, Q, eps);
+    return *fs_;
+}
+
+FreeSpace& Workspace::freeSpace(PolylinePtr P, PolylinePtr Q, double eps)
+{
+    if (fs_)
+        fs_->reset(std::move(P), std::move(Q), eps);
+    else
+        fs_ = std::make_unique<FreeSpace>(std::move(P), std::move(Q), eps);
+    return *fs_;
+}
+
+bool Workspace::decide(const Polyline& P, const Polyline& Q, double eps)
+{
+    FreeSpace& fs = freeSpace(P, Q, eps);
+    fs.computeReachability();
+    return fs.isTopRightReachable();
+}
+
+} // namespace Frechet
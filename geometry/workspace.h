@@ -0,0 +1,29 @@
+#pragma once
+#include "bounds.h"
+#include "freespace.h"
+#include <memory>
+
+namespace Frechet {
+
+// Owns the cell, interval, path and bound buffers for repeated
+// free-space construction. Buffers grow monotonically and are reset
+// rather than freed between pairs, so a steady-state batch run makes
+// no allocations per pair.
+class Workspace {
+public:
+    // FreeSpace for (P, Q, eps), built in the previous pair's buffers;
+    // the reference stays valid until the next call
+    FreeSpace& freeSpace(const Polyline& P, const Polyline& Q, double eps);
+    FreeSpace& freeSpace(PolylinePtr P, PolylinePtr Q, double eps);
+
+    // d_F(P,Q) <= eps through the full free space
+    bool decide(const Polyline& P, const Polyline& Q, double eps);
+
+    BoundsScratch& boundsScratch() { return scratch_; }
+
+private:
+    std::unique_ptr<FreeSpace> fs_;
+    BoundsScratch scratch_;
+};
+
+} // namespace Frechet
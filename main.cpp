@@ -1,9 +1,13 @@
 #include "mainwindow.h"
+#include "batch/batchtools.h"
 
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    if (Batch::isBatchCommand(argc, argv))
+        return Batch::run(argc, argv);
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
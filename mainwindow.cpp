@@ -6,11 +6,17 @@
 #include <QSlider>
 #include <QLabel>
 #include <QPushButton>
+#include <QCheckBox>
+#include <QSignalBlocker>
+#include <QtConcurrent>
 
 #include "canvas/polylinecanvas.h"
 #include "canvas/freespacecanvas.h"
 #include "geometry/freespace.h"
+#include "geometry/planner.h"
 #include "geometry/reachability.h"
+#include "geometry/resultcache.h"
+#include "geometry/weakfrechet.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -75,8 +81,11 @@ MainWindow::MainWindow(QWidget *parent)
     criticalEpsLabel = new QLabel(QString("Critical ε = ?"));
     criticalEpsLabel->setAlignment(Qt::AlignRight);
 
+    snapCheckBox = new QCheckBox("Snap to critical events");
+
     auto* epsLayout = new QHBoxLayout();
     epsLayout->addWidget(epsLabel);
+    epsLayout->addWidget(snapCheckBox);
     epsLayout->addWidget(criticalEpsLabel);
 
     rightLayout->addLayout(epsLayout);
@@ -85,11 +94,10 @@ MainWindow::MainWindow(QWidget *parent)
     mainLayout->addLayout(rightLayout, 1);
 
     // --- Polylines start empty ---
-    Polyline P, Q; // prazni
-    polylineCanvas->setPolylines(P, Q);
+    polylineCanvas->setPolylines(makePolyline(), makePolyline()); // prazni
 
     // freeSpace se ne kreira dok korisnik ne učita fajl
-    freeSpace.reset();
+    freeSpace = nullptr;
 
     freeSpaceCanvas->setFreeSpace(nullptr);
 
@@ -100,6 +108,37 @@ MainWindow::MainWindow(QWidget *parent)
     connect(polylineCanvas, &PolylineCanvas::polylinesLoaded,
             this, &MainWindow::onPolylinesLoaded);
 
+    // setFuture() stops reporting the previous pair, and any pair loaded
+    // in the meantime keeps its own label
+    distanceWatcher = new QFutureWatcher<double>(this);
+    connect(distanceWatcher, &QFutureWatcher<double>::finished, this, [this]() {
+        if (!distancePending)
+            return;
+        distancePending = false;
+        criticalEpsLabel->setText(QString("Critical ε = %1 (too large to draw)")
+                                      .arg(distanceWatcher->result(), 0, 'f', 3));
+    });
+
+    // until the sweeps arrive the slider recomputes the diagram directly
+    sweepWatcher = new QFutureWatcher<Sweeps>(this);
+    connect(sweepWatcher, &QFutureWatcher<Sweeps>::finished, this, [this]() {
+        if (!sweepPending)
+            return;
+        sweepPending = false;
+
+        Sweeps sweeps = sweepWatcher->result();
+        epsTimeline = sweeps.timeline;
+        weakEps = sweeps.weakEps;
+        if (sweeps.scrubber && freeSpace) {
+            sweeps.scrubber->attach(*freeSpace);
+            epsScrubber = sweeps.scrubber;
+        }
+
+        onEpsChanged(epsSlider->value());
+        if (freeSpace && freeSpace->pathComputed)
+            showCriticalEps();
+    });
+
     setWindowTitle("Frechet Distance Visualizer");
     resize(1100, 650);
 }
@@ -113,30 +152,44 @@ MainWindow::~MainWindow()
 // Slot
 void MainWindow::onEpsChanged(int value)
 {
+    // snap to the first slider position past the nearest critical event
+    if (epsTimeline && snapCheckBox->isChecked()) {
+        int snapped = static_cast<int>(std::ceil(epsTimeline->snap(value)));
+        snapped = std::clamp(snapped, epsSlider->minimum(), epsSlider->maximum());
+        if (snapped != value) {
+            QSignalBlocker blocker(epsSlider);
+            epsSlider->setValue(snapped);
+            value = snapped;
+        }
+    }
+
     epsLabel->setText(QString("ε = %1").arg(value));
 
     if (!freeSpace)
         return;
 
-    // Update eps and recompute reachability
-    freeSpace->setEps(value);
-    freeSpace->computeReachability();
+    // apply the stored deltas to the new eps, or recompute everything
+    if (epsScrubber) {
+        epsScrubber->seek(value);
+    } else {
+        freeSpace->setEps(value);
+        freeSpace->computeReachability();
+    }
     freeSpaceCanvas->update();
 
     if (!freeSpace->pathComputed && freeSpace->isTopRightReachable()) {
-        freeSpace->criticalPath = freeSpace->computeCriticalPath();
+        auto& cache = Frechet::ResultCache::instance();
+        if (!cache.findCriticalPath(pairKey, freeSpace->criticalPath)) {
+            freeSpace->computeCriticalPath(freeSpace->criticalPath);
+            cache.storeCriticalPath(pairKey, freeSpace->criticalPath);
+        }
         freeSpace->pathComputed = true;
         freeSpace->criticalEps = value;
 
         polylineCanvas->generateAnimationPositions(freeSpace->criticalPath);
         polylineCanvas->startAnimation();
         restartAnimButton->setEnabled(true);
-        criticalEpsLabel->setText(QString("Critical ε ≈ %1").arg(value));
-        criticalEpsLabel->setStyleSheet(
-            "color: #00A36C;"
-            "font-size: 17px;"
-            "font-weight: bold;"
-            );
+        showCriticalEps();
     }
 
     if (freeSpace->criticalPath.empty()) {
@@ -149,22 +202,76 @@ void MainWindow::onEpsChanged(int value)
     }
 }
 
-void MainWindow::onPolylinesLoaded(const Polyline& P, const Polyline& Q)
+void MainWindow::showCriticalEps()
 {
+    // while the timeline is still being swept only the slider value that
+    // first reached the end is known, an upper bound
+    if (epsTimeline)
+        criticalEpsLabel->setText(QString("Critical ε = %1 (weak %2)")
+                                      .arg(epsTimeline->criticalEps(), 0, 'f', 3)
+                                      .arg(weakEps, 0, 'f', 3));
+    else
+        criticalEpsLabel->setText(QString("Critical ε ≤ %1 (computing)").arg(freeSpace->criticalEps));
+    criticalEpsLabel->setStyleSheet(
+        "color: #00A36C;"
+        "font-size: 17px;"
+        "font-weight: bold;"
+        );
+}
+
+void MainWindow::onPolylinesLoaded(PolylinePtr P, PolylinePtr Q)
+{
+    epsScrubber.reset();
+    epsTimeline.reset();
+    distancePending = false;
+    sweepPending = false;
     polylineCanvas->resetAnimation();
     polylineCanvas->setPolylines(P, Q);
     adjustEpsSliderRange();
 
-    freeSpace.reset();
-
-    if (!P.vertices.empty() && !Q.vertices.empty()) {
-        freeSpace = std::make_unique<FreeSpace>(P, Q, epsSlider->value());
-        freeSpaceCanvas->setFreeSpace(freeSpace.get());
-    }
+    freeSpace = nullptr;
+    freeSpaceCanvas->setFreeSpace(nullptr);
 
     criticalEpsLabel->setText("Critical ε = ?");
     criticalEpsLabel->setStyleSheet("");
     restartAnimButton->setEnabled(false);
+
+    if (!P->vertices.empty() && !Q->vertices.empty()) {
+        // the diagram and its matching must fit in memory to be drawn,
+        // otherwise only the distance is shown
+        Frechet::Planner planner(*P, *Q);
+        if (!planner.fits(Frechet::Planner::Engine::LocalMatching)) {
+            criticalEpsLabel->setText("Critical ε = … (too large to draw, computing)");
+            distancePending = true;
+            distanceWatcher->setFuture(QtConcurrent::run([P, Q]() {
+                return Frechet::Planner(*P, *Q).distance();
+            }));
+            return;
+        }
+
+        freeSpace = &workspace.freeSpace(P, Q, epsSlider->value());
+        freeSpaceCanvas->setFreeSpace(freeSpace);
+        pairKey = Frechet::ResultCache::key(*P, *Q);
+
+        // one-time sweeps of the critical events for the slider and of the
+        // diagram states at every slider position, off the GUI thread
+        int first = epsSlider->minimum();
+        int last = epsSlider->maximum();
+        qint64 maxBytes = Frechet::Planner::availableMemory() / 8;
+        sweepPending = true;
+        sweepWatcher->setFuture(QtConcurrent::run([P, Q, first, last, maxBytes]() {
+            Sweeps sweeps;
+            sweeps.timeline = std::make_shared<Frechet::EpsTimeline>(*P, *Q);
+            sweeps.weakEps = Frechet::weakFrechetDistance(*P, *Q);
+
+            FreeSpace diagram(P, Q, first);
+            auto scrubber = std::make_shared<Frechet::EpsScrubber>(diagram, first, last, maxBytes);
+            if (scrubber->isValid())
+                sweeps.scrubber = scrubber;
+            return sweeps;
+        }));
+        onEpsChanged(epsSlider->value());
+    }
 }
 
 void MainWindow::adjustEpsSliderRange() {
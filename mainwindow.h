@@ -3,10 +3,15 @@
 
 #include "canvas/polylinecanvas.h"
 #include "canvas/freespacecanvas.h"
+#include "geometry/epsscrubber.h"
+#include "geometry/epstimeline.h"
+#include "geometry/workspace.h"
 #include <QMainWindow>
 #include <QSlider>
 #include <QLabel>
 #include <QPushButton>
+#include <QCheckBox>
+#include <QFutureWatcher>
 #include <memory>
 
 QT_BEGIN_NAMESPACE
@@ -27,19 +32,39 @@ public:
 
     void adjustEpsSliderRange();
 private:
+    void showCriticalEps();
+
     Ui::MainWindow *ui;
     PolylineCanvas* polylineCanvas;
     FreeSpaceCanvas* freeSpaceCanvas;
-    std::unique_ptr<FreeSpace> freeSpace;
+    Frechet::Workspace workspace;   // reused across loads
+    FreeSpace* freeSpace = nullptr; // lives in workspace
+    std::shared_ptr<Frechet::EpsTimeline> epsTimeline;
+    std::shared_ptr<Frechet::EpsScrubber> epsScrubber; // on freeSpace, if it fits
+    QByteArray pairKey;             // result cache key of the loaded pair
+    double weakEps = 0.0;           // weak Frechet distance of the loaded pair
+
+    // the one-time sweeps of a loaded pair, run in the background; the
+    // scrubber sweeps a private diagram and is attached to freeSpace on arrival
+    struct Sweeps {
+        std::shared_ptr<Frechet::EpsTimeline> timeline;
+        double weakEps = 0.0;
+        std::shared_ptr<Frechet::EpsScrubber> scrubber; // null if it does not fit
+    };
+    QFutureWatcher<Sweeps>* sweepWatcher;
+    bool sweepPending = false;      // for the pair loaded last
+    QFutureWatcher<double>* distanceWatcher; // distance of a pair too large to draw
+    bool distancePending = false;             // for the pair loaded last
     QSlider* epsSlider;
     QLabel* epsLabel;
     QLabel* criticalEpsLabel;
+    QCheckBox* snapCheckBox;
     QPushButton* restartAnimButton;
     QPushButton* loadPolylinesButton;
 
 private slots:
     void onEpsChanged(int value);
-    void onPolylinesLoaded(const Polyline& P, const Polyline& Q);
+    void onPolylinesLoaded(PolylinePtr P, PolylinePtr Q);
 
 };
 #endif // MAINWINDOW_H